@@ -0,0 +1,195 @@
+// Benchmark of the simulation update (No window, prints JSON)
+/*
+* Build (Linux):
+* g++ -std=c++17 -O2 benchmark.cpp src/Simulation.cpp src/EnemyPool.cpp src/BulletPool.cpp src/PathRegistry.cpp src/SpatialGrid.cpp src/Profiler.cpp src/Trace.cpp src/JobSystem.cpp src/Archetypes.cpp src/GameMap.cpp -pthread -o benchmark
+*
+* How to use:
+* ./benchmark [ticks] [threads] [--state file]
+* E.g. ./benchmark 600 > result.json -> Every scenario runs 600 measured ticks of 1/60 second
+* E.g. ./benchmark 600 0             -> Same, with the whole tick on the main thread
+* E.g. ./benchmark 600 4 --state late.tdsv -> One more scenario starting from a saved match (See headless --save)
+*
+* Every scenario keeps N enemies on the path (Killed or escaped enemies are replaced) and
+* N towers on the playfield, then measures Simulation::tick, which spawns enemies, updates
+* towers, bullets and enemies.
+* save_ns / load_ns: Time to save the match at the end of the scenario to memory and load it back.
+*/
+
+#include "src/Simulation.h"
+#include "src/JobSystem.h"
+#include "src/BinaryStream.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// Count every heap allocation of the program
+static std::atomic<long long> allocationCount(0);
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+struct ScenarioResult {
+    std::string name;
+    int enemies;
+    int towers;
+    int ticks;
+    double nsPerTick;
+    double allocationsPerTick;
+    long long p50;
+    long long p99;
+    long long max;
+    long long saveNs;
+    long long loadNs;
+};
+
+// count enemies and count towers, or the match saved in stateFile (Keeps as many enemies as it has)
+ScenarioResult runScenario(int count, int ticks, const std::string& stateFile = std::string()) {
+    const float deltaTime = 1.0f / 60.0f;
+    const int warmupTicks = 60;
+
+    Simulation simulation(Simulation::builtinMap(0), 1);
+    Pcg32 script(12345); // Same enemies and towers every run
+
+    if (!stateFile.empty()) {
+        if (!simulation.loadState(stateFile)) {
+            std::exit(1);
+        }
+        count = int(simulation.getEnemies().size());
+    }
+    else {
+        for (int i = 0; i < count; ++i) {
+            Vec2 position(script.nextFloat() * PLAYFIELD_WIDTH, script.nextFloat() * (PLAYFIELD_HEIGHT - 50.0f));
+            simulation.addTower(TowerType(script.range(0, TOWER_TYPE_COUNT - 1)), position);
+        }
+    }
+    float pathLength = simulation.getPaths().get(0).totalLength; // After loading, the save may bring its own map
+
+    std::vector<long long> tickTimes;
+    tickTimes.reserve(ticks);
+    long long allocations = 0;
+
+    for (int tick = 0; tick < warmupTicks + ticks; ++tick) {
+        // Keep the scenario size (Not measured)
+        while (int(simulation.getEnemies().size()) < count) {
+            simulation.addEnemy(EnemyType(script.range(0, 3)), script.nextFloat() * pathLength);
+        }
+        simulation.setLife(1000000000); // Escaped enemies must not end the match
+
+        long long allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+
+        simulation.tick(deltaTime);
+
+        auto end = std::chrono::steady_clock::now();
+        long long allocationsAfter = allocationCount.load(std::memory_order_relaxed);
+
+        SimEvent event;
+        while (simulation.pollEvent(event)) {
+        }
+
+        if (tick >= warmupTicks) {
+            tickTimes.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            allocations += allocationsAfter - allocationsBefore;
+        }
+    }
+
+    ScenarioResult result;
+    result.enemies = count;
+    result.towers = int(simulation.getTowers().size());
+    result.name = std::to_string(result.enemies) + " enemies / " + std::to_string(result.towers) + " towers";
+    if (!stateFile.empty()) {
+        result.name = stateFile + ": " + result.name;
+    }
+    result.ticks = ticks;
+
+    auto saveStart = std::chrono::steady_clock::now();
+    BinaryWriter writer;
+    simulation.writeState(writer);
+    auto loadStart = std::chrono::steady_clock::now();
+    BinaryReader reader(writer.getBytes());
+    Simulation loaded(Simulation::builtinMap(0), 1);
+    if (!loaded.readState(reader)) {
+        std::cerr << "Saved state did not load back" << std::endl;
+    }
+    auto loadEnd = std::chrono::steady_clock::now();
+    result.saveNs = std::chrono::duration_cast<std::chrono::nanoseconds>(loadStart - saveStart).count();
+    result.loadNs = std::chrono::duration_cast<std::chrono::nanoseconds>(loadEnd - loadStart).count();
+
+    long long total = 0;
+    for (long long time : tickTimes) {
+        total += time;
+    }
+    std::sort(tickTimes.begin(), tickTimes.end());
+    result.nsPerTick = double(total) / ticks;
+    result.allocationsPerTick = double(allocations) / ticks;
+    result.p50 = tickTimes[tickTimes.size() / 2];
+    result.p99 = tickTimes[std::min(tickTimes.size() - 1, tickTimes.size() * 99 / 100)];
+    result.max = tickTimes.back();
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    // "--state file" may come after the numbers
+    std::string stateFile;
+    std::vector<std::string> numbers;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--state" && i + 1 < argc) {
+            stateFile = argv[++i];
+        }
+        else {
+            numbers.push_back(argv[i]);
+        }
+    }
+    int ticks = (numbers.size() > 0) ? std::atoi(numbers[0].c_str()) : 600;
+    if (ticks <= 0) {
+        std::cerr << "Usage: benchmark [ticks] [threads] [--state file]" << std::endl;
+        return 1;
+    }
+    if (numbers.size() > 1) {
+        JobSystem::get().setThreadCount(std::atoi(numbers[1].c_str()));
+    }
+
+    std::vector<int> counts = { 10, 100, 1000, 10000 };
+    if (!stateFile.empty()) {
+        counts.push_back(-1);
+    }
+
+    std::cout << "{\n  \"ticks\": " << ticks << ",\n  \"threads\": " << JobSystem::get().getThreadCount() << ",\n  \"scenarios\": [\n";
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        ScenarioResult result = (counts[i] < 0) ? runScenario(0, ticks, stateFile) : runScenario(counts[i], ticks);
+        std::cout << "    {\"name\": \"" << result.name << "\""
+            << ", \"enemies\": " << result.enemies
+            << ", \"towers\": " << result.towers
+            << ", \"ns_per_tick\": " << result.nsPerTick
+            << ", \"allocations_per_tick\": " << result.allocationsPerTick
+            << ", \"p50_ns\": " << result.p50
+            << ", \"p99_ns\": " << result.p99
+            << ", \"max_ns\": " << result.max
+            << ", \"save_ns\": " << result.saveNs
+            << ", \"load_ns\": " << result.loadNs << "}"
+            << (i + 1 < counts.size() ? "," : "") << "\n";
+    }
+    std::cout << "  ]\n}" << std::endl;
+
+    return 0;
+}
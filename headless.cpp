@@ -0,0 +1,206 @@
+// Headless driver (Run a match without window or audio, e.g. on CI machines)
+/*
+* Build (Linux):
+* g++ -std=c++17 -O2 headless.cpp src/Simulation.cpp src/EnemyPool.cpp src/BulletPool.cpp src/PathRegistry.cpp src/SpatialGrid.cpp src/Profiler.cpp src/Trace.cpp src/JobSystem.cpp src/Archetypes.cpp src/GameMap.cpp src/Replay.cpp -pthread -o headless
+*
+* How to use:
+* ./headless [level] [ticks] [tickRate] [seed] [--record file] [--load file] [--save file] [--archetypes file] [--map file]
+* E.g. ./headless 0 100000 60 7 -> Level 1, 100000 ticks of 1/60 second, random seed 7
+* E.g. ./headless 0 6000 60 7 --save late.tdsv -> Same for 6000 ticks, then save the match (See benchmark --state)
+* E.g. ./headless 0 6000 --load late.tdsv -> Go on with a saved match (Level and seed come from the save)
+* E.g. ./headless 0 100000 --archetypes test.txt -> Tower and enemy stats from test.txt (See Archetypes.h)
+* E.g. ./headless 0 100000 --map test.map -> Play test.map instead of a built-in level (See GameMap.h)
+* ./headless --replay file
+* E.g. ./headless --replay match.tdrp -> Re-simulate a recorded match as fast as possible and show the slowest ticks
+*/
+
+#include "src/Simulation.h"
+#include "src/Replay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Slowest ticks shown after a replay
+const std::size_t SLOWEST_TICKS_SHOWN = 5;
+
+void printStats(const Simulation& simulation, long long ticksRun, float deltaTime, long long towerShots, double seconds) {
+    std::cout << "seed: " << simulation.getSeed() << std::endl;
+    std::cout << "ticks: " << ticksRun << " (" << ticksRun * deltaTime << " s of game time)" << std::endl;
+    std::cout << "waves: " << simulation.getWaveNumber() - 1 << std::endl;
+    std::cout << "kills: " << simulation.getKills() << std::endl;
+    std::cout << "life: " << simulation.getLife() << std::endl;
+    std::cout << "money: " << simulation.getMoney() << std::endl;
+    std::cout << "towers: " << simulation.getTowers().size() << std::endl;
+    std::cout << "shots: " << towerShots << std::endl;
+    std::cout << "game over: " << (simulation.isGameOver() ? "yes" : "no") << std::endl;
+    std::cout << "ticks/second: " << (seconds > 0 ? ticksRun / seconds : 0) << std::endl;
+}
+
+long long countShots(Simulation& simulation) {
+    long long shots = 0;
+    SimEvent event;
+    while (simulation.pollEvent(event)) {
+        if (event.type == SimEventType::TowerFired) {
+            shots++;
+        }
+    }
+    return shots;
+}
+
+int playReplay(const std::string& filename) {
+    Replay replay;
+    if (!replay.load(filename)) {
+        return 1;
+    }
+
+    Simulation simulation(replay.map, replay.seed, replay.archetypes);
+    ReplayPlayer player(replay);
+    std::vector<std::pair<long long, long long>> tickTimes; // (Nanoseconds, tick)
+    tickTimes.reserve(std::size_t(replay.totalTicks));
+    long long towerShots = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    while (true) {
+        auto tickStart = std::chrono::steady_clock::now();
+        long long tick = (long long)player.getTick();
+        if (!player.step(simulation)) {
+            break;
+        }
+        auto tickEnd = std::chrono::steady_clock::now();
+        tickTimes.push_back(std::make_pair((long long)std::chrono::duration_cast<std::chrono::nanoseconds>(tickEnd - tickStart).count(), tick));
+        towerShots += countShots(simulation);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "replay: " << filename << " (" << replay.commands.size() << " commands)" << std::endl;
+    printStats(simulation, (long long)player.getTick(), 1.0f / replay.tickRate, towerShots, std::chrono::duration<double>(end - start).count());
+
+    // Where the spikes are (Replay again up to that tick with a profiler or tracer attached)
+    std::size_t shown = std::min(SLOWEST_TICKS_SHOWN, tickTimes.size());
+    std::partial_sort(tickTimes.begin(), tickTimes.begin() + shown, tickTimes.end(),
+        [](const std::pair<long long, long long>& a, const std::pair<long long, long long>& b) { return a.first > b.first; });
+    for (std::size_t i = 0; i < shown; ++i) {
+        std::cout << "slow tick " << tickTimes[i].second << ": " << tickTimes[i].first / 1000000.0 << " ms" << std::endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2 && std::string(argv[1]) == "--replay") {
+        return playReplay(argv[2]);
+    }
+
+    // "--record file", "--load file", "--save file", "--archetypes file" and "--map file" may come after the numbers
+    std::string recordFile, loadFile, saveFile, archetypeFile, mapFile;
+    std::vector<std::string> numbers;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--record" && i + 1 < argc) {
+            recordFile = argv[++i];
+        }
+        else if (std::string(argv[i]) == "--load" && i + 1 < argc) {
+            loadFile = argv[++i];
+        }
+        else if (std::string(argv[i]) == "--save" && i + 1 < argc) {
+            saveFile = argv[++i];
+        }
+        else if (std::string(argv[i]) == "--archetypes" && i + 1 < argc) {
+            archetypeFile = argv[++i];
+        }
+        else if (std::string(argv[i]) == "--map" && i + 1 < argc) {
+            mapFile = argv[++i];
+        }
+        else {
+            numbers.push_back(argv[i]);
+        }
+    }
+    int level = (numbers.size() > 0) ? std::atoi(numbers[0].c_str()) : 0;
+    long long ticks = (numbers.size() > 1) ? std::atoll(numbers[1].c_str()) : 100000;
+    float tickRate = (numbers.size() > 2) ? float(std::atof(numbers[2].c_str())) : 60.0f;
+    unsigned long long seed = (numbers.size() > 3) ? std::strtoull(numbers[3].c_str(), nullptr, 10) : 1;
+
+    if (level < 0 || level >= Simulation::builtinMapCount() || ticks <= 0 || tickRate <= 0 || (!recordFile.empty() && !loadFile.empty())) {
+        std::cerr << "Usage: headless [level 0-" << Simulation::builtinMapCount() - 1 << "] [ticks] [tickRate] [seed] [--record file] [--load file] [--save file] [--archetypes file] [--map file]" << std::endl;
+        std::cerr << "       (A replay starts from a new match, so --record and --load cannot be used together)" << std::endl;
+        std::cerr << "       headless --replay file" << std::endl;
+        return 1;
+    }
+
+    ArchetypeTable archetypes;
+    if (!archetypeFile.empty() && !archetypes.load(archetypeFile)) {
+        return 1;
+    }
+
+    GameMap map = Simulation::builtinMap(level);
+    if (!mapFile.empty() && !map.load(mapFile)) {
+        return 1;
+    }
+
+    Simulation simulation(map, seed, archetypes);
+    float deltaTime = 1.0f / tickRate;
+    if (!loadFile.empty() && !simulation.loadState(loadFile)) {
+        return 1;
+    }
+
+    ReplayRecorder recorder;
+    if (!recordFile.empty()) {
+        recorder.start(recordFile, simulation.getMap(), seed, tickRate, simulation.getArchetypes());
+    }
+
+    // Scripted player: build towers beside every corner of the paths whenever money allows
+    std::vector<Vec2> towerSpots;
+    for (const MapPath& path : simulation.getMap().paths) {
+        for (const auto& waypoint : path.waypoints) {
+            if (simulation.getMap().canBuildAt(waypoint + Vec2(30.0f, 30.0f))) {
+                towerSpots.push_back(waypoint + Vec2(30.0f, 30.0f));
+            }
+        }
+    }
+    std::size_t nextSpot = std::min(simulation.getTowers().size(), towerSpots.size()); // Towers of a loaded match were placed already
+
+    long long towerShots = 0;
+    long long ticksRun = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (; ticksRun < ticks && !simulation.isGameOver(); ++ticksRun) {
+        if (nextSpot < towerSpots.size()) {
+            SimCommand command;
+            command.type = SimCommandType::PlaceTower;
+            command.towerType = TowerType(nextSpot % 3);
+            command.position = towerSpots[nextSpot];
+            if (simulation.getMoney() >= simulation.getTowerCost(command.towerType)) {
+                simulation.apply(command);
+                recorder.record(ticksRun, command);
+                nextSpot++;
+            }
+        }
+
+        simulation.tick(deltaTime);
+        towerShots += countShots(simulation);
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    if (loadFile.empty()) {
+        const GameMap& map = simulation.getMap();
+        std::cout << "map: " << map.name << " (" << map.routes.size() << " routes)" << std::endl;
+    }
+    else {
+        std::cout << "loaded: " << loadFile << std::endl;
+    }
+    printStats(simulation, ticksRun, deltaTime, towerShots, std::chrono::duration<double>(end - start).count());
+    recorder.finish(ticksRun);
+
+    if (!saveFile.empty()) {
+        auto saveStart = std::chrono::steady_clock::now();
+        if (!simulation.saveState(saveFile)) {
+            return 1;
+        }
+        std::cout << "saved to " << saveFile << " in " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - saveStart).count() << " ms" << std::endl;
+    }
+
+    return 0;
+}
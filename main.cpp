@@ -6,6 +6,20 @@
 #include <cmath>
 #include <random>
 #include <fstream>
+#include <chrono>
+#include <cstdlib>
+
+#include "src/Simulation.h"
+#include "src/rss_Manager.h"
+#include "src/AudioMixer.h"
+#include "src/EntityBatch.h"
+#include "src/HudValue.h"
+#include "src/ProfilerOverlay.h"
+#include "src/Trace.h"
+#include "src/JobSystem.h"
+#include "src/SimulationThread.h"
+#include "src/Replay.h"
+#include "src/Archetypes.h"
 
 ///Debug usage
 #include <iostream>
@@ -108,16 +122,11 @@ void readHistoryTextFile(const std::string& historyFilePath, int pathHistoryScor
 }
 
 
-// - Random from a range using a specific type
-template <typename InputType>
-InputType random(InputType Min, InputType Max) {
-    // Uniformly-distributed integer random number generator
-    std::random_device rd;
-    // Mersenne twister (High quality number but with more storage space requirement)
-    std::mt19937 generator(rd());
-    // Produces random floating-point values x, uniformly distributed on the interval [Min,Max)
-    std::uniform_real_distribution<> dist(Min, Max + 1);
-    return InputType(dist(generator));
+// - Random integer from [Min, Max] (Menu and music only, the match has its own seeded RandomService)
+int random(int Min, int Max) {
+    // Seeded once from the system, then a cheap PCG32 step per call
+    static Pcg32 generator(std::random_device{}());
+    return generator.range(Min, Max);
 }
 
 // Global Variable
@@ -126,14 +135,25 @@ float backgroundMusic = 100.0f; // Music
 const std::string filePath = "Game File/Game Setting.txt"; // Setting file Path
 const std::string historyFilePath = "Game File/History Score.txt"; // Setting Historyfile Path
 
-std::vector<sf::Vector2f> pathList[5];// Path list
+// Quick save of a level (F5 saves, F9 loads, see Simulation::saveState)
+std::string saveFilePath(int level) {
+    return "Game File/Save Level " + std::to_string(level + 1) + ".tdsv";
+}
+// Map of a level (Written from the built-in map the first time, see GameMap)
+std::string mapFilePath(int level) {
+    return "Game File/Map Level " + std::to_string(level + 1) + ".map";
+}
+float simulationTickRate = 60.0f; // Simulation steps per second (Independent of the frame rate)
+const int maxCatchUpTicks = 5; // Most simulation steps run in one frame, a longer stall is dropped
+std::string recordReplayFile; // Save every match as a replay to this file (--record), empty = off
+const std::string archetypeFilePath = "Game File/Archetypes.txt"; // Tower and enemy stats (Edited while the game runs)
+ArchetypeTable archetypeTable; // Loaded from archetypeFilePath at startup and when it changes during a match
+
 int pathHistoryScore[5]; // History Highest
 
 // Forward declarations
 class SoundPlayer;
-class Enemy;
 class Tower;
-class Bullet;
 class Game;
 
 // Global game instance
@@ -143,42 +163,45 @@ Game* g_game = nullptr;
 class SoundPlayer {
 /*
 * How to use:
-* SoundPlayer NameYouWant;
+* SoundPlayer NameYouWant; (Or SoundPlayer NameYouWant{SoundCategory::Music}; for BGM)
 * NameYouWant.playSound("NameOfFileWithoutPath.wav", 100.f, 1.0f, VariableOfGameSettingLinkedToThisAudio, false);
 * 
+* The sound is played on a voice of the AudioMixer, if the mixer needs the voice for a newer
+* sound this player stops like the sound ended.
 */
 public:
+    SoundPlayer(SoundCategory category = SoundCategory::Effect) : category(category) {}
 
     // Play the sound with the input parameter (filename don't need path)
     void playSound(const std::string filename, float setVolume = 100.f, float Pitch = 1.0f, float SettingVolume = 1.0f, bool setLoop = false) {
+        TraceScope trace("SoundPlayer::playSound");
         IsPaused = false;
         NoAudio = false;
 
-        std::string filePathAndName = "src/assets/audio/" + filename;
-        if (!buffer.loadFromFile(filePathAndName)) {
-            // Error handling if audio loading fails
+        // A looping sound would never give its voice back, stop it before playing the next one
+        sf::Sound* previous = AudioMixer::get().find(voice);
+        if (previous != nullptr && previous->getLoop()) {
+            previous->stop();
         }
 
-        //Associate a sound buffer to the sound object
-        sound.setBuffer(buffer);
-
-        // Audio Setting
-        sound.setPitch(Pitch);
-        sound.setVolume(setVolume * SettingVolume / 100); // Setting is store in range [0, 100], we want it to be percentage
-        sound.setLoop(setLoop);
-        sound.play();
+        // Setting is store in range [0, 100], we want it to be percentage
+        voice = AudioMixer::get().play(category, filename, setVolume * SettingVolume / 100, Pitch, setLoop);
     }
 
     // Set the Volume
     void volume(float setVolume, float SettingVolume) {
-        sound.setVolume(setVolume * SettingVolume / 100);
+        if (sf::Sound* sound = AudioMixer::get().find(voice)) {
+            sound->setVolume(setVolume * SettingVolume / 100);
+        }
     }
 
     // Stop the audio
     void stop() {
         IsPaused = false;
         NoAudio = true;
-        sound.stop();
+        if (sf::Sound* sound = AudioMixer::get().find(voice)) {
+            sound->stop();
+        }
     }
 
     // Pause the audio
@@ -186,7 +209,9 @@ public:
         if (IsPaused == false) {
             IsPaused = true;
             NoAudio = false;
-            sound.pause();
+            if (sf::Sound* sound = AudioMixer::get().find(voice)) {
+                sound->pause();
+            }
         }
     }
 
@@ -195,15 +220,19 @@ public:
         if (IsPaused == true) {
             IsPaused = false;
             NoAudio = false;
-            sound.play();
+            if (sf::Sound* sound = AudioMixer::get().find(voice)) {
+                sound->play();
+            }
         }
     }
 
     // Go to the next "offset" second
     void offset(float offset = 1.f) {
-        sound.pause();
-        sound.setPlayingOffset(sf::seconds(offset));
-        sound.play();
+        if (sf::Sound* sound = AudioMixer::get().find(voice)) {
+            sound->pause();
+            sound->setPlayingOffset(sf::seconds(offset));
+            sound->play();
+        }
     }
 
     // Return true if music pause
@@ -218,173 +247,32 @@ public:
 
     // Update method to check sound status and handle delayed loop
     void update() {
-        if (sound.getStatus() == sf::Sound::Stopped && !NoAudio) {
+        sf::Sound* sound = AudioMixer::get().find(voice);
+        if ((sound == nullptr || sound->getStatus() == sf::Sound::Stopped) && !NoAudio) {
             NoAudio = true;
         }
     }
 
 private:
-    //const char* filenameList[10];
-    sf::SoundBuffer buffer;
-    sf::Sound sound;
+    SoundCategory category;
+    VoiceHandle voice;
     bool IsPaused = false, NoAudio = true; // Also set to false when music is stop (Pause)
 };
 
-// Enemy class
-class Enemy {
-private:
-    std::unique_ptr<sf::Shape> shape;
-    sf::RectangleShape hpBar;
-    sf::RectangleShape hpBarBackground;
-    float speed;
-    int health;
-    int maxHealth;
-    std::vector<sf::Vector2f> waypoints;
-    size_t currentWaypoint;
-    bool dead;
-
-public:
-    int getHealth() const {
-        return health;
-    }
-    Enemy(std::vector<sf::Vector2f> path, float speed, int health, std::unique_ptr<sf::Shape> shape)
-        : speed(speed), health(health), maxHealth(health), waypoints(path), currentWaypoint(0), dead(false), shape(std::move(shape)) {
-        this->shape->setPosition(waypoints[0]);
-        this->shape->setOrigin(this->shape->getLocalBounds().width / 2.0f, this->shape->getLocalBounds().height / 2.0f);
-
-        // Set up HP bar
-        hpBarBackground.setSize(sf::Vector2f(30, 5));
-        hpBarBackground.setFillColor(sf::Color::Black);
-        hpBarBackground.setOrigin(hpBarBackground.getSize().x / 2.0f, hpBarBackground.getSize().y / 2.0f);
-
-        hpBar.setSize(sf::Vector2f(30, 5));
-        hpBar.setFillColor(sf::Color::Red);
-        hpBar.setOrigin(hpBar.getSize().x / 2.0f, hpBar.getSize().y / 2.0f);
-    }
-
-    void update(float deltaTime) {
-        if (currentWaypoint < waypoints.size()) {
-            sf::Vector2f direction = waypoints[currentWaypoint] - shape->getPosition();
-            float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
-
-            if (length <= speed * deltaTime) {
-                shape->setPosition(waypoints[currentWaypoint]);
-                currentWaypoint++;
-            }
-            else {
-                sf::Vector2f velocity = direction / length * speed;
-                shape->move(velocity * deltaTime);
-            }
-        }
-
-        // Update HP bar position
-        hpBarBackground.setPosition(shape->getPosition() + sf::Vector2f(0, -20));
-        hpBar.setPosition(shape->getPosition() + sf::Vector2f(0, -20));
-
-        // Update HP bar size based on health
-        float hpPercent = static_cast<float>(health) / maxHealth;
-        hpBar.setSize(sf::Vector2f(30 * hpPercent, 5));
-    }
-
-    void draw(sf::RenderWindow& window) const {
-        window.draw(*shape);
-        window.draw(hpBarBackground);
-        window.draw(hpBar);
-    }
-
-    void damage(int amount) {
-        health -= amount;
-        if (health <= 0) {
-            dead = true;
-        }
-
-        // Change color when receiving damage
-        shape->setFillColor(sf::Color::White);
-    }
-
-    bool isDead() const {
-        return dead;
-    }
-
-    bool isOutOfBounds() const {
-        return currentWaypoint >= waypoints.size();
-    }
-
-    sf::Vector2f getPosition() const {
-        return shape->getPosition();
-    }
-
-    void setHealth(int newHealth) {
-        health = newHealth;
-        if (health <= 0) {
-            dead = true;
-        }
-    }
-};
-
-// Bullet class
-class Bullet {
-private:
-    sf::CircleShape shape;
-    sf::Vector2f velocity;
-    int damage;
-    bool dead;
-
-public:
-    Bullet(sf::Vector2f position, sf::Vector2f velocity, int damage)
-        : velocity(velocity), damage(damage), dead(false) {
-        shape.setRadius(5.0f);
-        shape.setFillColor(sf::Color::Yellow);
-        shape.setPosition(position);
-        shape.setOrigin(5.0f, 5.0f);
-    }
-
-    void update(float deltaTime, std::vector<Enemy>& enemies) {
-        shape.move(velocity * deltaTime);
-
-        // Check collision with enemies
-        for (auto& enemy : enemies) {
-            if (!enemy.isDead() && shape.getGlobalBounds().intersects(sf::FloatRect(enemy.getPosition() - sf::Vector2f(10.0f, 10.0f), sf::Vector2f(20.0f, 20.0f)))) {
-                enemy.damage(damage);
-                dead = true;
-                break;
-            }
-        }
-
-        // Check if bullet is out of bounds
-        if (shape.getPosition().x < 0 || shape.getPosition().x > 800 ||
-            shape.getPosition().y < 0 || shape.getPosition().y > 600) {
-            dead = true;
-        }
-    }
-
-    void draw(sf::RenderWindow& window) const {
-        window.draw(shape);
-    }
-
-    bool isDead() const { return dead; }
-};
-
-// Tower class
+// Tower class (How a placed tower looks, the tower itself lives in the Simulation)
 class Tower {
 private:
     sf::CircleShape shape;
     sf::CircleShape rangeCircle;
-    sf::Text levelText;
-    sf::Font font;
+    HudValue levelText;
     float range;
-    float attackTimer;
-    float attackCooldown;
-    float radius;
-    int damage;
-    std::vector<Bullet> bullets;
     sf::Color color;
     int level;
-    SoundPlayer audioPlayer;
+    SoundPlayer audioPlayer{SoundCategory::TowerShot};
 
 public:
-    Tower(float x, float y, float range, int damage, float attackCooldown, sf::Color color, float radius)
-        : range(range), attackTimer(0), attackCooldown(attackCooldown), damage(damage), color(color), level(1) {
+    Tower(float x, float y, float range, sf::Color color, float radius)
+        : range(range), color(color), level(1) {
         shape.setRadius(radius);
         shape.setFillColor(color);
         shape.setPosition(x, y);
@@ -397,98 +285,17 @@ public:
         rangeCircle.setPosition(x, y);
         rangeCircle.setOrigin(range, range);
 
-        if (!font.loadFromFile("src/assets/font/Roboto-Black.ttf")) {
-            // Error handling if font loading fails
-        }
-
-        levelText.setFont(font);
+        levelText.setFont(ResourceManager::get().getFont(DEFAULT_FONT));
         levelText.setCharacterSize(12);
         levelText.setFillColor(sf::Color::White);
-        levelText.setString("Lv. " + std::to_string(level));
+        levelText.setLabel("Lv. ");
+        levelText.setValue(level);
         levelText.setPosition(x - 10, y - 10);
     }
 
-    bool isPointWithinRange(const sf::Vector2f& point) const {
-        return shape.getGlobalBounds().contains(point);
-    }
-
-    void update(float deltaTime, std::vector<Enemy>& enemies) {
-        attackTimer += deltaTime;
-        if (attackTimer >= attackCooldown) {
-            Enemy* targetEnemy = nullptr;
-
-            if (color == sf::Color::Blue) {
-                // Sniper tower targets the enemy with the highest HP
-                int maxHealth = 0;
-                for (auto& enemy : enemies) {
-                    if (!enemy.isDead() && enemy.getHealth() > maxHealth) {
-                        maxHealth = enemy.getHealth();
-                        targetEnemy = &enemy;
-                    }
-                }
-            }
-            else {
-                // Other towers target the closest enemy
-                float closestDist = range;
-                for (auto& enemy : enemies) {
-                    if (!enemy.isDead()) {
-                        float dist = std::sqrt(
-                            std::pow(enemy.getPosition().x - shape.getPosition().x, 2) +
-                            std::pow(enemy.getPosition().y - shape.getPosition().y, 2)
-                        );
-                        if (dist < closestDist) {
-                            closestDist = dist;
-                            targetEnemy = &enemy;
-                        }
-                    }
-                }
-            }
-
-            if (targetEnemy) {
-                // Calculate bullet velocity towards the enemy
-                sf::Vector2f direction = targetEnemy->getPosition() - shape.getPosition();
-                float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
-                sf::Vector2f velocity = direction / length * 300.0f;
-
-                // Spawn a bullet
-                bullets.emplace_back(shape.getPosition(), velocity, damage);
-                attackTimer = 0;
-
-                //Play Sound Effect base on type
-                if (color == sf::Color::Red) {
-                    //Basic
-                    audioPlayer.playSound("ArrowShoot2.wav", 100.f, 1.0f, soundEffect);
-                } else if (color == sf::Color::Green) {
-                    //Rapid
-                    audioPlayer.playSound("ArrowShoot2.wav", 100.f, 2.0f, soundEffect);
-                } else if (color == sf::Color::Blue) {
-                    //Sniper
-                    audioPlayer.playSound("ArrowShoot1.wav", 100.f, 1.0f, soundEffect);
-                } else {
-                    //If not set
-                    audioPlayer.playSound("ArrowShoot2.wav", 100.f, 1.0f, soundEffect);
-                }
-            }
-        }
-
-        // Update bullets
-        for (auto it = bullets.begin(); it != bullets.end();) {
-            it->update(deltaTime, enemies);
-            if (it->isDead()) {
-                it = bullets.erase(it);
-            }
-            else {
-                ++it;
-            }
-        }
-    }
-
     void draw(sf::RenderWindow& window) const {
         window.draw(shape);
         window.draw(levelText);
-        for (const auto& bullet : bullets) {
-            bullet.draw(window);
-        }
     }
 
     void drawRange(sf::RenderWindow& window) const {
@@ -504,16 +311,37 @@ public:
     sf::Vector2f getPosition() const {
         return shape.getPosition();
     }
-    void upgrade() {
-        level++;
-        damage += 10;
-        range += 20;
-        attackCooldown *= 0.9f;
+
+    // Follow the level and range of the simulated tower after an upgrade or new archetypes
+    void upgrade(int newLevel, float newRange) {
+        level = newLevel;
+        range = newRange;
 
         rangeCircle.setRadius(range);
         rangeCircle.setOrigin(range, range);
 
-        levelText.setString("Lv. " + std::to_string(level));
+        levelText.setValue(level);
+    }
+
+    //Play Sound Effect base on type
+    void playShootSound(TowerType type) {
+        if (type == TowerType::Basic) {
+            //Basic
+            audioPlayer.playSound("ArrowShoot2.wav", 100.f, 1.0f, soundEffect);
+        } else if (type == TowerType::Rapid) {
+            //Rapid
+            audioPlayer.playSound("ArrowShoot2.wav", 100.f, 2.0f, soundEffect);
+        } else if (type == TowerType::Sniper) {
+            //Sniper
+            audioPlayer.playSound("ArrowShoot1.wav", 100.f, 1.0f, soundEffect);
+        } else {
+            //If not set
+            audioPlayer.playSound("ArrowShoot2.wav", 100.f, 1.0f, soundEffect);
+        }
+    }
+
+    float getRange() const {
+        return range;
     }
 
     int getLevel() const {
@@ -523,12 +351,6 @@ public:
     sf::Color getColour() const {
         return color;
     }
-
-    float getRadius() const {
-        return radius;
-    }
-
-
 };
 
 // Meun class
@@ -538,27 +360,33 @@ private:
     class Game {
     private:
         sf::RenderWindow& window;
-        std::vector<Tower> towers;
-        std::vector<Enemy> enemies;
-        std::vector<sf::Vector2f> path;
+        SimulationThread simulation;   // Ticks on its own thread, this thread only draws snapshots
+        const SimSnapshot* snapshot;   // Newest state of the simulation (Taken once per frame)
+        std::vector<Tower> towers; // Same order as the towers of the snapshot
         sf::VertexArray pathVertices;
+        sf::VertexArray buildZoneVertices; // Where towers can be built (Empty if anywhere)
+        sf::View playfieldView;            // Map coordinates stretched over the window
+
+        // Enemy, HP bar and bullet drawing (One draw call each, enemies and bullets are rebuilt every frame,
+        // HP bars are only rewritten for enemies whose health or position changed)
+        EntityBatch entityBatch;
+
+        // Frame time overlay (F3)
+        ProfilerOverlay profilerOverlay;
 
         // Tower selection
         sf::RectangleShape towerSelectionBar;
         std::vector<sf::RectangleShape> towerButtons;
         std::vector<sf::Text> towerTexts;
-        sf::Font font;
+        const sf::Font& font;
         int selectedTower;
         bool placingTower;
         Tower* newTower;
 
         // UI elements
-        sf::Text lifeText;
-        sf::Text moneyText;
-        sf::Text killsText;
-        int playerLife;
-        int playerMoney;
-        int enemyKills;
+        HudValue lifeText;
+        HudValue moneyText;
+        HudValue killsText;
 
         bool showTutorial = false;
         sf::RectangleShape tutorialButton;
@@ -578,103 +406,69 @@ private:
         sf::RectangleShape backToStartButton;
         sf::Text backToStartButtonText;
 
-        int waveNumber;
-        bool bossSpawned;
-        float spawnTimer;
-        float spawnInterval;
         int CurrentLevel;
+        bool replaying;        // Commands come from a replay, not from the player
+        float ticksPerSecond;  // Simulation steps per second of real time
 
-        //variables for tracking difficulty and controling enemy health and spawn rate
-        float difficultyTimer;     // Time elapsed to increase difficulty
-        float healthMultiplier;      // Multiplier to increase enemy health
-        float spawnRateMultiplier;     // Multiplier to make enemies spawn faster
+        // Tower and enemy stats, checked for changes every second (Not while replaying)
+        ArchetypeTable archetypes;
+        ArchetypeWatcher archetypeWatcher;
+        sf::Clock archetypeClock;
 
     public:
-        Game(sf::RenderWindow& window, int level) : window(window),
+        // replay: Play this recorded match (On its own map) at replaySpeed times the normal speed instead of a new match
+        Game(sf::RenderWindow& window, int level, const GameMap& map, const Replay* replay = nullptr, float replaySpeed = 1.0f) : window(window),
+            simulation(replay ? replay->map : map, replay ? replay->seed : std::random_device{}(),
+                replay ? replay->archetypes : archetypeTable, replay ? replay->tickRate : simulationTickRate, maxCatchUpTicks),
+            snapshot(&simulation.acquireSnapshot()),
+            font(ResourceManager::get().getFont(DEFAULT_FONT)),
+            profilerOverlay(ResourceManager::get().getFont(DEFAULT_FONT), sf::Vector2f(540.0f, 10.0f)),
             isPaused(false), gameOver(false), toStart(false),
             selectedTower(0), placingTower(false), newTower(nullptr),
-            waveNumber(1), bossSpawned(false), spawnTimer(0), spawnInterval(2.0f), difficultyTimer(0.0f), healthMultiplier(1.0f), spawnRateMultiplier(1.0f),
-            pathVertices(sf::LineStrip),
-            playerLife(100), playerMoney(500), enemyKills(0) {
-
-            // Set up the list of path
-            pathList[0] = { //default map
-                sf::Vector2f(0, 100),
-                sf::Vector2f(200, 100),
-                sf::Vector2f(200, 200),
-                sf::Vector2f(400, 200),
-                sf::Vector2f(400, 100),
-                sf::Vector2f(600, 100),
-                sf::Vector2f(600, 300),
-                sf::Vector2f(400, 300),
-                sf::Vector2f(400, 400),
-                sf::Vector2f(200, 400),
-                sf::Vector2f(200, 500),
-                sf::Vector2f(800, 500)
-            };
-            pathList[1] = {
-                sf::Vector2f(0, 100),
-                sf::Vector2f(700, 100),
-                sf::Vector2f(700, 200),
-                sf::Vector2f(100, 200),
-                sf::Vector2f(100, 300),
-                sf::Vector2f(700, 300),
-                sf::Vector2f(700, 400),
-                sf::Vector2f(100, 400),
-                sf::Vector2f(100, 500),
-                sf::Vector2f(800, 500)
-            };
-            pathList[2] = {
-                sf::Vector2f(0, 100),
-                sf::Vector2f(600, 300),
-                sf::Vector2f(300, 150),
-                sf::Vector2f(150, 300),
-                sf::Vector2f(400, 300),
-                sf::Vector2f(200, 600),
-            };
-            pathList[3] = {
-                sf::Vector2f(0, 150),
-                sf::Vector2f(600, 150),
-                sf::Vector2f(600, 75),
-                sf::Vector2f(200, 75),
-                sf::Vector2f(200, 400),
-                sf::Vector2f(50, 400),
-                sf::Vector2f(50, 300),
-                sf::Vector2f(575, 300),
-                sf::Vector2f(575, 200),
-                sf::Vector2f(700, 200),
-                sf::Vector2f(700, 500),
-                sf::Vector2f(300, 500),
-                sf::Vector2f(300, 600)
-            };
-            pathList[4] = {
-                sf::Vector2f(0, 300),
-                sf::Vector2f(200, 300),
-                sf::Vector2f(200, 150),
-                sf::Vector2f(350, 150),
-                sf::Vector2f(350, 300),
-                sf::Vector2f(500, 300),
-                sf::Vector2f(500, 450),
-                sf::Vector2f(650, 450),
-                sf::Vector2f(650, 300),
-                sf::Vector2f(700, 300),
-                sf::Vector2f(650, 300),
-                sf::Vector2f(650, 450),
-                sf::Vector2f(500, 450),
-                sf::Vector2f(500, 300),
-                sf::Vector2f(350, 300),
-                sf::Vector2f(350, 150),
-                sf::Vector2f(200, 150),
-                sf::Vector2f(200, 300),
-                sf::Vector2f(0, 300)
-            };
-
-            path = pathList[level];
+            pathVertices(sf::Lines), buildZoneVertices(sf::Triangles), archetypeWatcher(archetypeFilePath) {
+
             CurrentLevel = level;
+            replaying = (replay != nullptr);
+            ticksPerSecond = simulation.getTickRate();
+            archetypes = replay ? replay->archetypes : archetypeTable;
+            if (replaying) {
+                simulation.playReplay(*replay, replaySpeed);
+                ticksPerSecond *= replaySpeed;
+            }
+            else if (!recordReplayFile.empty()) {
+                simulation.startRecording(recordReplayFile);
+            }
 
-            // Set up path vertices
-            for (const auto& waypoint : path) {
-                pathVertices.append(sf::Vertex(waypoint, sf::Color::White));
+            // Set up path vertices (One line per segment, paths may cross, branch and merge)
+            const GameMap& gameMap = simulation.getMap();
+            playfieldView = sf::View(sf::FloatRect(0.0f, 0.0f, gameMap.width, gameMap.height));
+            for (const MapPath& path : gameMap.paths) {
+                for (std::size_t i = 1; i < path.waypoints.size(); ++i) {
+                    pathVertices.append(sf::Vertex(sf::Vector2f(path.waypoints[i - 1].x, path.waypoints[i - 1].y), sf::Color::White));
+                    pathVertices.append(sf::Vertex(sf::Vector2f(path.waypoints[i].x, path.waypoints[i].y), sf::Color::White));
+                }
+            }
+            // Enemies walk straight from the end of a path to the start of its next paths
+            for (const MapLink& link : gameMap.links) {
+                for (const MapPath& from : gameMap.paths) {
+                    for (const MapPath& to : gameMap.paths) {
+                        if (from.name == link.from && to.name == link.to) {
+                            pathVertices.append(sf::Vertex(sf::Vector2f(from.waypoints.back().x, from.waypoints.back().y), sf::Color::White));
+                            pathVertices.append(sf::Vertex(sf::Vector2f(to.waypoints.front().x, to.waypoints.front().y), sf::Color::White));
+                        }
+                    }
+                }
+            }
+            for (const BuildZone& zone : gameMap.buildZones) {
+                sf::Color color(0, 255, 0, 40);
+                sf::Vector2f topLeft(zone.x, zone.y), topRight(zone.x + zone.width, zone.y);
+                sf::Vector2f bottomLeft(zone.x, zone.y + zone.height), bottomRight(zone.x + zone.width, zone.y + zone.height);
+                buildZoneVertices.append(sf::Vertex(topLeft, color));
+                buildZoneVertices.append(sf::Vertex(topRight, color));
+                buildZoneVertices.append(sf::Vertex(bottomRight, color));
+                buildZoneVertices.append(sf::Vertex(topLeft, color));
+                buildZoneVertices.append(sf::Vertex(bottomRight, color));
+                buildZoneVertices.append(sf::Vertex(bottomLeft, color));
             }
 
             // Set up tower selection bar
@@ -682,11 +476,6 @@ private:
             towerSelectionBar.setFillColor(sf::Color::White);
             towerSelectionBar.setPosition(0, window.getSize().y - 50.0f);
 
-            // Load font
-            if (!font.loadFromFile("src/assets/font/Roboto-Black.ttf")) {
-                // Error handling if font loading fails
-            }
-
             // Tutorial Button Setup
             tutorialButton.setSize(sf::Vector2f(70, 40));
             tutorialButton.setFillColor(sf::Color::Magenta);
@@ -700,7 +489,6 @@ private:
 
             // Set up Tutorial Text
             tutorialText.setFont(font);
-            tutorialText.setString("How to Play:\n1. Click on any tower options to place towers \n     and defend against enemies.\n     Price:\n     Basic :100 Rapid: 150 Sniper: 200\n2. Left-click: upgrade tower; right-click: sell tower\n3. Press P to pause the game.");
             tutorialText.setCharacterSize(20);
             tutorialText.setFillColor(sf::Color::White);
             tutorialText.setPosition(170, 215);
@@ -717,13 +505,11 @@ private:
 
             // Set up tower buttons
             std::vector<std::string> towerNames = { "Basic", "Rapid", "Sniper" };
-            std::vector<sf::Color> towerColors = { sf::Color::Red, sf::Color::Green, sf::Color::Blue };
             sf::Vector2f buttonSize(100.0f, 40.0f);
             sf::Vector2f buttonPosition(10.0f, window.getSize().y - 45.0f);
 
             for (int i = 0; i < towerNames.size(); ++i) {
                 sf::RectangleShape button(buttonSize);
-                button.setFillColor(towerColors[i]);
                 button.setPosition(buttonPosition);
                 towerButtons.push_back(button);
 
@@ -734,17 +520,21 @@ private:
 
                 buttonPosition.x += buttonSize.x + 10.0f;
             }
+            showArchetypes();
             lifeText.setFont(font);
+            lifeText.setLabel("Life: ");
             lifeText.setCharacterSize(20);
             lifeText.setFillColor(sf::Color::White);
             lifeText.setPosition(10.0f, 10.0f);
 
             moneyText.setFont(font);
+            moneyText.setLabel("Money: ");
             moneyText.setCharacterSize(20);
             moneyText.setFillColor(sf::Color::White);
             moneyText.setPosition(10.0f, 40.0f);
 
             killsText.setFont(font);
+            killsText.setLabel("Kills: ");
             killsText.setCharacterSize(20);
             killsText.setFillColor(sf::Color::White);
             killsText.setPosition(10.0f, 70.0f);
@@ -781,7 +571,7 @@ private:
             }
 
         void run() {
-            sf::Clock clock;
+            simulation.start();
 
             while (window.isOpen() && !toStart) {
 
@@ -792,12 +582,26 @@ private:
                     BGMaudioPlayer.playSound(SongSelect, 30, 1, backgroundMusic);
                 }
                 
-                float deltaTime = clock.restart().asSeconds();
+                {
+                    ScopedTimer frameTimer(ProfileZone::Frame);
+                    {
+                        ScopedTimer timer(ProfileZone::HandleEvents);
+                        handleEvents();
+                    }
 
-                handleEvents();
-                update(deltaTime);
-                render();
+                    // The simulation ticks on its own thread, take what it produced since the last frame
+                    update();
+
+                    // Draw between the snapshot and the tick before it, by the time since the snapshot
+                    float alpha = std::chrono::duration<float>(std::chrono::steady_clock::now() - snapshot->time).count() * ticksPerSecond;
+                    ScopedTimer timer(ProfileZone::Render);
+                    render((alpha < 1.0f) ? alpha : 1.0f);
+                }
+                Profiler::get().endFrame();
+                profilerOverlay.update();
             }
+
+            simulation.stop();
         }
 
         bool getStart() {
@@ -805,7 +609,7 @@ private:
         }
 
     private:
-        SoundPlayer ToweraudioPlayer, BGMaudioPlayer, GameaudioPlayer;
+        SoundPlayer ToweraudioPlayer, BGMaudioPlayer{SoundCategory::Music}, GameaudioPlayer;
         void handleEvents() {
             sf::Event event;
             while (window.pollEvent(event)) {
@@ -813,8 +617,21 @@ private:
                     window.close();
                 }
                 else if (event.type == sf::Event::KeyPressed) {
-                    if (event.key.code == sf::Keyboard::P) {
+                    if (event.key.code == sf::Keyboard::F3) {
+                        profilerOverlay.toggle(); // Show / hide frame times
+                    }
+                    else if (event.key.code == sf::Keyboard::F5 && !gameOver) {
+                        simulation.requestSave(saveFilePath(CurrentLevel));
+                    }
+                    else if (event.key.code == sf::Keyboard::F9 && !gameOver) {
+                        simulation.requestLoad(saveFilePath(CurrentLevel));
+                    }
+                    else if (event.key.code == sf::Keyboard::H) {
+                        entityBatch.setHideFullHealthBars(!entityBatch.getHideFullHealthBars()); // Show / hide HP bars of undamaged enemies
+                    }
+                    else if (event.key.code == sf::Keyboard::P && !replaying) { // A replay pauses where the player paused
                         isPaused = !isPaused; // Toggle pause state
+                        sendPaused();
 
                         // Audio changes if Pause game
                         GameaudioPlayer.playSound("Pause.wav", 100.f, 1.0f, soundEffect);
@@ -826,7 +643,7 @@ private:
                         
                     } else {
                         // If player use hotkey to place tower
-                        sf::Vector2f mousePosition(float(sf::Mouse::getPosition(window).x), float(sf::Mouse::getPosition(window).y));;
+                        sf::Vector2f mousePosition = toPlayfield(sf::Mouse::getPosition(window));
                         switch (event.key.code) {
                         case sf::Keyboard::B:
                         case sf::Keyboard::Num1:
@@ -849,7 +666,7 @@ private:
                         }
                         if (placingTower) {
                             ToweraudioPlayer.playSound("Building2.wav", 100.f, 1.0f, soundEffect);
-                            newTower = createTower(selectedTower, mousePosition);
+                            newTower = new Tower(createTower(selectedTower, mousePosition));
                         }
                         break;
                     }
@@ -869,39 +686,33 @@ private:
                 else if (event.type == sf::Event::MouseButtonPressed) {
                     if (event.mouseButton.button == sf::Mouse::Left) {
                         sf::Vector2f mousePosition(event.mouseButton.x, event.mouseButton.y);
+                        sf::Vector2f fieldPosition = toPlayfield(sf::Vector2i(event.mouseButton.x, event.mouseButton.y));
                         bool towerClicked = false;
 
                         // Check if the tutorial button is clicked
                         if (tutorialButton.getGlobalBounds().contains(mousePosition)) {
                             showTutorial = !showTutorial; // Toggle tutorial display
+                            sendPaused();
                             GameaudioPlayer.playSound("SelectSound.wav", 100.f, 1.0f, soundEffect);
                         }
 
                         // Check if a tower is clicked for upgrading or selling
-                        for (auto it = towers.begin(); it != towers.end(); ++it) {
-                            if (it->isPointWithinRange(mousePosition)) {
-                                // Check if a tower is clicked for upgrading
-                                
-                                // Leave if in placing mode
-                                if (placingTower) {
-                                    ToweraudioPlayer.playSound("CannotPlaceHere.wav", 100.f, 1.0f, soundEffect);
-                                    towerClicked = true;
-                                    break;
-                                }
-                                // Clicked for upgrading
-                                int upgradeCost = getUpgradeCost(*it);
-                                if (playerMoney >= upgradeCost) {
-                                    ToweraudioPlayer.playSound("Upgrade1.wav", 100.f, 1.0f, soundEffect);
-                                    it->upgrade();
-                                    playerMoney -= upgradeCost;
-                                }
-                                else if (playerMoney <  upgradeCost) {
-                                    //Play sound effect when there are not enough money
-                                    ToweraudioPlayer.playSound("NotEnoughMoney.wav", 100.f, 1.0f, soundEffect);
-                                }
-                                towerClicked = true;
-                                break;
+                        int clickedTower = Simulation::findTowerAt(snapshot->towers, Vec2(fieldPosition.x, fieldPosition.y));
+                        if (clickedTower >= 0) {
+                            // Check if a tower is clicked for upgrading
+
+                            // Leave if in placing mode
+                            if (placingTower) {
+                                ToweraudioPlayer.playSound("CannotPlaceHere.wav", 100.f, 1.0f, soundEffect);
                             }
+                            // Clicked for upgrading (Sound plays when the simulation answers)
+                            else {
+                                SimCommand command;
+                                command.type = SimCommandType::UpgradeTower;
+                                command.position = Vec2(fieldPosition.x, fieldPosition.y);
+                                simulation.submit(command);
+                            }
+                            towerClicked = true;
                         }
 
                         if (!towerClicked && !placingTower) {
@@ -910,7 +721,7 @@ private:
                                 if (towerButtons[i].getGlobalBounds().contains(mousePosition)) {
                                     selectedTower = i;
                                     placingTower = true;
-                                    newTower = createTower(selectedTower, mousePosition);
+                                    newTower = new Tower(createTower(selectedTower, fieldPosition));
                                     ToweraudioPlayer.playSound("Building2.wav", 100.f, 1.0f, soundEffect);
                                     break;
                                 }
@@ -919,41 +730,35 @@ private:
                         else if (!towerClicked && placingTower) {
                             // Place the tower if the mouse is not on the tower selection bar
                             if (mousePosition.y < window.getSize().y - 50.0f) {
-                                int towerCost = getTowerCost(selectedTower);
-                                if (playerMoney >= towerCost) {
-                                    towers.push_back(*newTower);
-                                    playerMoney -= towerCost;
-                                    placingTower = false;
-                                    newTower = nullptr;
-                                    ToweraudioPlayer.playSound("Building1.wav", 100.f, 1.0f, soundEffect);
-                                } else {
-                                    // Cancil placing tower if not enough money
-                                    ToweraudioPlayer.playSound("NotEnoughMoney.wav", 100.f, 1.0f, soundEffect);
-                                    placingTower = false;
-                                    break;
-                                }
+                                // Placed or cancelled if there is not enough money (Sound plays when the simulation answers)
+                                sf::Vector2f towerPosition = newTower->getPosition();
+                                SimCommand command;
+                                command.type = SimCommandType::PlaceTower;
+                                command.towerType = TowerType(selectedTower);
+                                command.position = Vec2(towerPosition.x, towerPosition.y);
+                                simulation.submit(command);
+                                placingTower = false;
+                                delete newTower;
+                                newTower = nullptr;
                             }
                         }
                     }
                     else if (event.mouseButton.button == sf::Mouse::Right) {
-                        sf::Vector2f mousePosition(event.mouseButton.x, event.mouseButton.y);
+                        sf::Vector2f mousePosition = toPlayfield(sf::Vector2i(event.mouseButton.x, event.mouseButton.y));
                         bool towerClicked = false;
                         if (placingTower) {
                             placingTower = false;
                         }
                         else if (!placingTower) {
-                            for (std::vector<Tower>::iterator it = towers.begin(); it != towers.end(); ++it) { // auto == std::vector<Tower>::iterator
-                                //Right click cancil placing tower mode
-                                if (it->isPointWithinRange(mousePosition)) {
-                                    // Check if a tower is clicked for selling
-                                    if (event.mouseButton.button == sf::Mouse::Right) {
-                                        towers.erase(it); // Remove tower
-                                        ToweraudioPlayer.playSound("GetMoney.wav", 100.f, 1.0f, soundEffect);
-                                        towerClicked = true;
-                                        playerMoney += (getTowerCost(selectedTower) / 2);
-                                        break;
-                                    }
-                                }
+                            // Check if a tower is clicked for selling
+                            int clickedTower = Simulation::findTowerAt(snapshot->towers, Vec2(mousePosition.x, mousePosition.y));
+                            if (clickedTower >= 0) {
+                                // Remove tower (Refund half of its price)
+                                SimCommand command;
+                                command.type = SimCommandType::SellTower;
+                                command.position = Vec2(mousePosition.x, mousePosition.y);
+                                simulation.submit(command);
+                                towerClicked = true;
                             }
                         }
                         
@@ -961,196 +766,226 @@ private:
                 }
                 else if (event.type == sf::Event::MouseMoved) {
                     if (placingTower) {
-                        sf::Vector2f mousePosition(event.mouseMove.x, event.mouseMove.y);
-                        newTower->setPosition(mousePosition);
+                        newTower->setPosition(toPlayfield(sf::Vector2i(event.mouseMove.x, event.mouseMove.y)));
                     }
                 }
             }
         }
 
-        void update(float deltaTime) {
-            if (isPaused || gameOver || showTutorial) {
-                return; // Skip the update logic if the game is paused
+        void update() {
+            TraceScope trace("Game::update");
+            reloadArchetypes();
+
+            // Play audio for what happened in the simulation
+            {
+                ScopedTimer audioTimer(ProfileZone::Audio);
+                SimEvent event;
+                while (simulation.pollEvent(event)) {
+                    switch (event.type) {
+                    case SimEventType::TowerFired:
+                        if (event.towerIndex < towers.size()) { // A tower sold since the last snapshot may shift the indices
+                            towers[event.towerIndex].playShootSound(event.towerType);
+                        }
+                        break;
+                    case SimEventType::EnemyKilled:
+                        GameaudioPlayer.playSound("GetMoney.wav", 100.f, 1.0f, soundEffect);
+                        break;
+                    case SimEventType::EnemyReachedEnd:
+                        GameaudioPlayer.playSound("LooseLife.wav", 100.f, 1.0f, soundEffect);
+                        break;
+                    case SimEventType::GameOver:
+                        //Handle with audio
+                        BGMaudioPlayer.stop();
+                        GameaudioPlayer.playSound("GameOver.wav", 100.f, 1.0f, soundEffect);
+                        break;
+                    case SimEventType::TowerPlaced:
+                        ToweraudioPlayer.playSound("Building1.wav", 100.f, 1.0f, soundEffect);
+                        break;
+                    case SimEventType::TowerUpgraded:
+                        ToweraudioPlayer.playSound("Upgrade1.wav", 100.f, 1.0f, soundEffect);
+                        break;
+                    case SimEventType::TowerSold:
+                        ToweraudioPlayer.playSound("GetMoney.wav", 100.f, 1.0f, soundEffect);
+                        break;
+                    case SimEventType::NotEnoughMoney:
+                        //Play sound effect when there are not enough money
+                        ToweraudioPlayer.playSound("NotEnoughMoney.wav", 100.f, 1.0f, soundEffect);
+                        break;
+                    case SimEventType::CannotBuildHere:
+                        ToweraudioPlayer.playSound("CannotPlaceHere.wav", 100.f, 1.0f, soundEffect);
+                        break;
+                    }
+                }
             }
 
-            difficultyTimer += deltaTime;
-            if (difficultyTimer >= 30.0f) { // Every 30 seconds
-                healthMultiplier += 0.2f;        // Increase enemy health by 20%
-                spawnRateMultiplier *= 0.9f;     // Make spawn interval faster by 10%
-                spawnInterval *= spawnRateMultiplier; // Update the spawn interval
-                difficultyTimer = 0.0f;          // Reset the difficulty timer
-                //std::cout << "Difficulty increased! Health x" << healthMultiplier << ", Spawn Interval x" << spawnRateMultiplier << std::endl;
-            }
+            // Taken after the events, so it already contains everything they talk about
+            snapshot = &simulation.acquireSnapshot();
+            syncTowers();
 
-            spawnTimer += deltaTime;
-            if (spawnTimer >= spawnInterval) {
-                spawnEnemy();
-                spawnTimer = 0;
+            // The player left the recorded match before it was over: end it here too
+            if (replaying && simulation.isReplayFinished() && !gameOver) {
+                gameOver = true;
+                gameOverText.setString("Replay Over");
             }
 
-            for (auto& tower : towers) {
-                tower.update(deltaTime, enemies);
+            if (snapshot->gameOver && !gameOver) {
+                gameOver = true; // Set game over state
+                if (replaying) {
+                    return; // Not a score of the player
+                }
+                pathHistoryScore[CurrentLevel] = (pathHistoryScore[CurrentLevel] > snapshot->kills) ? pathHistoryScore[CurrentLevel] : snapshot->kills;
+                initializeHistoryFile(historyFilePath, pathHistoryScore);
             }
 
-            for (auto it = enemies.begin(); it != enemies.end();) {
-                it->update(deltaTime);
+            // Only rebuilt when the number changed
+            lifeText.setValue(snapshot->life);
+            moneyText.setValue(snapshot->money);
+            killsText.setValue(snapshot->kills);
+        }
 
-                if (it->isDead()) {
-                    playerMoney += 50; // Increase player's money when an enemy is killed
-                    GameaudioPlayer.playSound("GetMoney.wav", 100.f, 1.0f, soundEffect);
-                    enemyKills++;
-                    it = enemies.erase(it);
-                }
-                else if (it->isOutOfBounds()) {
-                    playerLife -= 10; // Decrease player's life when an enemy reaches the end
-                    GameaudioPlayer.playSound("LooseLife.wav", 100.f, 1.0f, soundEffect);
-                    it = enemies.erase(it);
+        // Follow the towers of the snapshot (Placed, upgraded and sold towers)
+        void syncTowers() {
+            const std::vector<SimTower>& simTowers = snapshot->towers;
+            if (towers.size() > simTowers.size()) {
+                towers.erase(towers.begin() + simTowers.size(), towers.end());
+            }
+            for (std::size_t i = 0; i < simTowers.size(); ++i) {
+                sf::Vector2f position(simTowers[i].position.x, simTowers[i].position.y);
+                if (i == towers.size()) {
+                    towers.push_back(createTower(int(simTowers[i].type), position));
                 }
-                else {
-                    ++it;
+                else if (towers[i].getPosition() != position) {
+                    towers[i] = createTower(int(simTowers[i].type), position); // Towers after a sold one moved down
                 }
-            }
-
-            // Check if player's life reaches zero
-            if (playerLife <= 0) {
-                if (!gameOver) {
-                    //Handle with audio
-                    BGMaudioPlayer.stop();
-                    pathHistoryScore[CurrentLevel] = (pathHistoryScore[CurrentLevel] > enemyKills) ? pathHistoryScore[CurrentLevel] : enemyKills;
-                    initializeHistoryFile(historyFilePath, pathHistoryScore);
-                    GameaudioPlayer.playSound("GameOver.wav", 100.f, 1.0f, soundEffect);
+                if (towers[i].getLevel() != simTowers[i].level || towers[i].getRange() != simTowers[i].range) {
+                    towers[i].upgrade(simTowers[i].level, simTowers[i].range);
                 }
-                gameOver = true; // Set game over state
             }
-
-            lifeText.setString("Life: " + std::to_string(playerLife));
-            moneyText.setString("Money: " + std::to_string(playerMoney));
-            killsText.setString("Kills: " + std::to_string(enemyKills));
         }
 
-        void render() {
-            window.clear();
+        // Window pixel to map coordinates (Where the playfield is drawn)
+        sf::Vector2f toPlayfield(const sf::Vector2i& pixel) const {
+            return window.mapPixelToCoords(pixel, playfieldView);
+        }
 
-            // Draw path vertices
-            window.draw(pathVertices);
+        // The simulation stops while paused or while the tutorial is shown
+        void sendPaused() {
+            SimCommand command;
+            command.type = SimCommandType::SetPaused;
+            command.paused = isPaused || showTutorial;
+            simulation.submit(command);
+        }
 
-            // Draw game objects
-            for (const auto& enemy : enemies) {
-                enemy.draw(window);
-            }
-            for (const auto& tower : towers) {
-                tower.draw(window);
-            }
+        // alpha: Fraction of a tick since the last simulation step (Draw between the last two steps)
+        void render(float alpha) {
+            TraceScope trace("Game::render");
+            {
+                ScopedTimer drawTimer(ProfileZone::DrawSubmission); // Everything but display() (Which waits for vsync)
+                window.clear();
+
+                // Draw the playfield in map coordinates
+                window.setView(playfieldView);
+                window.draw(buildZoneVertices);
+                window.draw(pathVertices);
+
+                // Draw game objects
+                // Paused: nothing moves, draw where things are
+                if (isPaused || gameOver || showTutorial) {
+                    alpha = 1.0f;
+                }
+                entityBatch.buildEnemies(snapshot->enemies, alpha);
+                entityBatch.buildHealthBars(snapshot->enemies, alpha);
+                entityBatch.drawEnemies(window);
+                entityBatch.drawHealthBars(window);
+                for (const auto& tower : towers) {
+                    tower.draw(window);
+                }
+                entityBatch.buildBullets(snapshot->bullets, alpha);
+                entityBatch.drawBullets(window);
 
-            // Draw tower range if placing a tower
-            if (placingTower) {
-                newTower->drawRange(window);
-            }
+                // Draw tower range if placing a tower
+                if (placingTower) {
+                    newTower->drawRange(window);
+                }
 
-            // Draw UI elements
-            window.draw(towerSelectionBar);
-            for (const auto& button : towerButtons) {
-                window.draw(button);
-            }
-            for (const auto& text : towerTexts) {
-                window.draw(text);
-            }
+                // Draw UI elements (In window pixels)
+                window.setView(window.getDefaultView());
+                window.draw(towerSelectionBar);
+                for (const auto& button : towerButtons) {
+                    window.draw(button);
+                }
+                for (const auto& text : towerTexts) {
+                    window.draw(text);
+                }
 
-            // Draw UI texts
-            window.draw(lifeText);
-            window.draw(moneyText);
-            window.draw(killsText);
+                // Draw UI texts
+                window.draw(lifeText);
+                window.draw(moneyText);
+                window.draw(killsText);
 
-            // Draw tutorial button
-            window.draw(tutorialButton);
-            window.draw(tutorialButtonText);
+                // Draw tutorial button
+                window.draw(tutorialButton);
+                window.draw(tutorialButtonText);
 
-            if (showTutorial && !isPaused) {
-                window.draw(tutorialBackground);
-                window.draw(tutorialText); // Draw tutorial text
-            }
+                if (showTutorial && !isPaused) {
+                    window.draw(tutorialBackground);
+                    window.draw(tutorialText); // Draw tutorial text
+                }
 
-            if (isPaused && !gameOver) {
-                window.draw(pauseText); // Draw pause text
-            }
+                if (isPaused && !gameOver) {
+                    window.draw(pauseText); // Draw pause text
+                }
                 
-            if (gameOver) {
-                window.draw(gameOverText); // Draw Game Over
-                window.draw(closeButton);
-                window.draw(closeButtonText);
-                window.draw(backToStartButton);
-                window.draw(backToStartButtonText);
+                if (gameOver) {
+                    window.draw(gameOverText); // Draw Game Over
+                    window.draw(closeButton);
+                    window.draw(closeButtonText);
+                    window.draw(backToStartButton);
+                    window.draw(backToStartButtonText);
+                }
+
+                profilerOverlay.draw(window);
             }
 
             window.display();
         }
 
-        void spawnEnemy() {
-            if (!bossSpawned && waveNumber % 5 == 0) {
-                // Spawn boss enemy
-                auto bossShape = std::make_unique<sf::CircleShape>(20.0f);
-                bossShape->setFillColor(sf::Color::Magenta);
-                int bossHealth = static_cast<int>(1000 * healthMultiplier);
-                enemies.emplace_back(path, 50.0f, 500, std::move(bossShape));
-                bossSpawned = true;
-            }
-            else {
-                // Spawn regular enemies
-                if (waveNumber % 3 == 0) {
-                    // Fast enemy with low health
-                    auto fastShape = std::make_unique<sf::CircleShape>(5.0f);
-                    fastShape->setFillColor(sf::Color::Cyan);
-                    int fastHealth = static_cast<int>(200 * healthMultiplier);
-                    enemies.emplace_back(path, 200.0f, 50, std::move(fastShape));
-                }
-                else if (waveNumber % 3 == 1) {
-                    // Slow enemy with high health
-                    auto slowShape = std::make_unique<sf::RectangleShape>(sf::Vector2f(20.0f, 20.0f));
-                    slowShape->setFillColor(sf::Color::Green);
-                    int slowHealth = static_cast<int>(200 * healthMultiplier);
-                    enemies.emplace_back(path, 50.0f, 150, std::move(slowShape));
-                }
-                else {
-                    // Normal enemy
-                    auto normalShape = std::make_unique<sf::CircleShape>(10.0f);
-                    normalShape->setFillColor(sf::Color::Red);
-                    int normalEnemyHealth = static_cast<int>(200 * healthMultiplier);
-                    enemies.emplace_back(path, 100.0f, 100, std::move(normalShape));
-                }
-            }
-
-            waveNumber++;
+        Tower createTower(int type, const sf::Vector2f& position) {
+            const TowerArchetype& stats = archetypes.tower(TowerType(type));
+            // Tower(float x, float y, float range, sf::Color color, float radius)
+            return Tower(position.x, position.y, stats.range, sf::Color(stats.color), stats.radius);
         }
 
-        Tower* createTower(int type, const sf::Vector2f& position) {
-            switch (type) {
-                // Tower(float x, float y, float range, int damage, float attackCooldown, sf::Color color, float radius)
-            case 0:
-                return new Tower(position.x, position.y, 100.0f, 50, 1.0f, sf::Color::Red, 20.0f);
-            case 1:
-                return new Tower(position.x, position.y, 80.0f, 30, 0.5f, sf::Color::Green, 15.0f);
-            case 2:
-                return new Tower(position.x, position.y, 150.0f, 100, 2.0f, sf::Color::Blue, 25.0f);
-            default:
-                return nullptr;
+        // Colors, prices and enemy looks of the archetypes (At the start and after the file changed)
+        void showArchetypes() {
+            for (std::size_t i = 0; i < towerButtons.size(); ++i) {
+                towerButtons[i].setFillColor(sf::Color(archetypes.towers[i].color));
             }
+            tutorialText.setString("How to Play:\n1. Click on any tower options to place towers \n     and defend against enemies.\n     Price:\n     Basic :"
+                + std::to_string(archetypes.tower(TowerType::Basic).cost) + " Rapid: " + std::to_string(archetypes.tower(TowerType::Rapid).cost)
+                + " Sniper: " + std::to_string(archetypes.tower(TowerType::Sniper).cost)
+                + "\n2. Left-click: upgrade tower; right-click: sell tower\n3. Press P to pause the game.");
+            entityBatch.setLooks(archetypes);
         }
 
-        int getTowerCost(int type) {
-            switch (type) {
-            case 0:
-                return 100;
-            case 1:
-                return 150;
-            case 2:
-                return 200;
-            default:
-                return 0;
+        // Hot reload: use the archetype file as soon as it is saved
+        void reloadArchetypes() {
+            if (replaying || archetypeClock.getElapsedTime().asSeconds() < 1.0f) {
+                return;
+            }
+            archetypeClock.restart();
+            ArchetypeTable reloaded = archetypes;
+            if (archetypeWatcher.poll(reloaded)) {
+                if (!simulation.setArchetypes(reloaded)) {
+                    std::cerr << "New tower and enemy stats are not used while recording a replay" << std::endl;
+                    return;
+                }
+                archetypes = reloaded;
+                archetypeTable = archetypes;
+                showArchetypes();
+                towers.clear(); // Created again with the new look by syncTowers
+                std::cout << "Reloaded " << archetypeFilePath << std::endl;
             }
-        }
-
-        int getUpgradeCost(const Tower& tower) {
-            return tower.getLevel() * 100; // Adjust the upgrade cost formula as needed
         }
     };
 
@@ -1162,7 +997,6 @@ private:
             sf::RectangleShape bar;
             sf::RectangleShape handle;
             sf::Text valueText; // Text written on RHS
-            sf::Font font;
             bool isDragging;
             float value;
 
@@ -1249,7 +1083,7 @@ private:
         };
 
 
-        sf::Font font;
+        const sf::Font& font;
         sf::Text titleText, Sound, Music;
         sf::Text startButtonText, exitButtonText;
         sf::RectangleShape startButton, exitButton;
@@ -1258,7 +1092,7 @@ private:
         Slider soundEffectSlider;
         Slider backgroundMusicSlider;
 
-        SoundPlayer BGMaudioPlayer, EffectaudioPlayer;
+        SoundPlayer BGMaudioPlayer{SoundCategory::Music}, EffectaudioPlayer;
 
         bool startGame;
 
@@ -1270,7 +1104,7 @@ private:
             button.setPosition(position);
         }
         // Init Button Text
-        void initializeButtonText(sf::Text& buttonText, sf::Font& font, const std::string& text, unsigned int characterSize, const sf::Color& color, const sf::RectangleShape& button) {
+        void initializeButtonText(sf::Text& buttonText, const sf::Font& font, const std::string& text, unsigned int characterSize, const sf::Color& color, const sf::RectangleShape& button) {
             buttonText.setFont(font);
             buttonText.setString(text);
             buttonText.setCharacterSize(characterSize);
@@ -1283,9 +1117,9 @@ private:
         }
 
         StartScreen(sf::RenderWindow& window)
-            : window(window), soundEffectSlider(font, 540, 15, soundEffect), backgroundMusicSlider(font, 540, 50, backgroundMusic) {
-            // Load font
-            if (!font.loadFromFile("src/assets/font/Roboto-Black.ttf")) {
+            : window(window), font(ResourceManager::get().getFont(DEFAULT_FONT)),
+            soundEffectSlider(font, 540, 15, soundEffect), backgroundMusicSlider(font, 540, 50, backgroundMusic) {
+            if (!ResourceManager::get().isLoaded(DEFAULT_FONT)) {
                 throw std::runtime_error("Failed to load font");
             }
 
@@ -1395,6 +1229,7 @@ private:
                             BGMaudioPlayer.stop();
                         } else if (exitButton.getGlobalBounds().contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
                             EffectaudioPlayer.playSound("SelectSound.wav", 100.f, 1.0f, soundEffect);
+                            Tracer::stop(); // No match runs on the start screen, so no other thread records
                             exit(0);
                         }
                     }
@@ -1421,7 +1256,7 @@ private:
     class SelectionScreen {
     private:
         sf::RenderWindow& window;
-        sf::Font font;
+        const sf::Font& font;
         sf::Text titleText, HistoryHighest;
         std::vector<sf::Text> levelTexts, LevelHistoryHighest;
         sf::RectangleShape backButton;
@@ -1430,7 +1265,7 @@ private:
 
         std::vector<std::string> levels;
 
-        SoundPlayer BGMaudioPlayer, EffectaudioPlayer;
+        SoundPlayer BGMaudioPlayer{SoundCategory::Music}, EffectaudioPlayer;
 
         int selectedIndex;
         bool selected, isMainMenu, HighestScoreRendered = false;
@@ -1443,7 +1278,7 @@ private:
             button.setPosition(position);
         }
         // Init Button Text
-        void initializeButtonText(sf::Text& buttonText, sf::Font& font, const std::string& text, unsigned int characterSize, const sf::Color& color, const sf::RectangleShape& button) {
+        void initializeButtonText(sf::Text& buttonText, const sf::Font& font, const std::string& text, unsigned int characterSize, const sf::Color& color, const sf::RectangleShape& button) {
             buttonText.setFont(font);
             buttonText.setString(text);
             buttonText.setCharacterSize(characterSize);
@@ -1456,9 +1291,8 @@ private:
         }
 
         SelectionScreen(sf::RenderWindow& window)
-            : window(window), levels({ "Level 1", "Level 2", "Level 3", "Level 4", "Level 5" }) {
-            // Load font
-            if (!font.loadFromFile("src/assets/font/Roboto-Black.ttf")) {
+            : window(window), font(ResourceManager::get().getFont(DEFAULT_FONT)), levels({ "Level 1", "Level 2", "Level 3", "Level 4", "Level 5" }) {
+            if (!ResourceManager::get().isLoaded(DEFAULT_FONT)) {
                 throw std::runtime_error("Failed to load font");
             }
 
@@ -1660,7 +1494,6 @@ private:
 
 
     sf::RenderWindow window;
-    sf::Font font;
     StartScreen startScreen;
     SelectionScreen selectionScreen;
 
@@ -1668,8 +1501,8 @@ private:
     enum class State { StartScreen, LevelSelection, Playing};
     State currentState;
 
-    // Paths for levels
-    std::vector<std::string> paths;
+    // Maps of the levels (Loaded once, see mapFilePath)
+    std::vector<GameMap> maps;
 
     // Audio Player
 
@@ -1678,22 +1511,36 @@ public:
     Menu()
         : window(sf::VideoMode(800, 600), "Tower Defense"),
         currentState(State::StartScreen),
-        paths({ "path1.txt", "path2.txt", "path3.txt", "path4.txt", "path5.txt" }),
         startScreen(window),
         selectionScreen(window) {
-
-        if (!font.loadFromFile("src/assets/font/Roboto-Black.ttf")) {
-            throw std::runtime_error("Failed to load font");
+        for (int level = 0; level < Simulation::builtinMapCount(); ++level) {
+            std::string mapFile = mapFilePath(level);
+            GameMap map;
+            if (!std::ifstream(mapFile)) {
+                // First start: write the built-in map, so there is a file to edit
+                map = Simulation::builtinMap(level);
+                map.save(mapFile);
+            }
+            else if (!map.load(mapFile)) {
+                std::cerr << "Using the built-in map of level " << level + 1 << std::endl;
+                map = Simulation::builtinMap(level);
+            }
+            maps.push_back(map);
         }
     }
+    // Play a recorded match (--replay), the menu can be used after it
+    void runReplay(const Replay& replay, float speed) {
+        Game game(window, 0, replay.map, &replay, speed);
+        game.run();
+    }
+
     void run() {
 
         // Set Exe Icon
-        sf::Image* icon = new sf::Image();
-        if (icon->loadFromFile("src/assets/textures/icon.jpg")) {
-            window.setIcon(icon->getSize().x, icon->getSize().y, icon->getPixelsPtr());
+        const sf::Image& icon = ResourceManager::get().getImage("icon.jpg");
+        if (ResourceManager::get().isLoaded("icon.jpg")) {
+            window.setIcon(icon.getSize().x, icon.getSize().y, icon.getPixelsPtr());
         }
-        delete icon; // No longer use
 
 
         while (window.isOpen()) {
@@ -1725,7 +1572,7 @@ public:
                 break;
 
             case State::Playing:
-                Game game(window, selectionScreen.getSelectedLevel());
+                Game game(window, selectionScreen.getSelectedLevel(), maps[selectionScreen.getSelectedLevel()]);
                 game.run();
 
                 startScreen.initialize();
@@ -1740,13 +1587,60 @@ public:
     }
 };
 
-int main() {
+int main(int argc, char* argv[]) {
+    // "--trace [file]": Record a Chrome trace of the session (Written when the game closes)
+    // "--record file": Save the match as a replay (Written when the match ends)
+    // "--replay file [--speed N]": Watch a replay, N times faster
+    std::string replayFile;
+    float replaySpeed = 1.0f;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--trace") {
+            bool hasFile = i + 1 < argc && std::string(argv[i + 1]).compare(0, 2, "--") != 0;
+            Tracer::start(hasFile ? argv[++i] : "trace.json");
+        }
+        else if (argument == "--record" && i + 1 < argc) {
+            recordReplayFile = argv[++i];
+        }
+        else if (argument == "--replay" && i + 1 < argc) {
+            replayFile = argv[++i];
+        }
+        else if (argument == "--speed" && i + 1 < argc) {
+            replaySpeed = float(std::atof(argv[++i]));
+        }
+    }
+
     //Read fron Game Setting.txt to get user setting
     readTextFile(filePath, soundEffect, backgroundMusic);
     readHistoryTextFile(historyFilePath, pathHistoryScore);
 
-    Menu menu;
-    menu.run();
+    // Tower and enemy stats (Write the built-in ones the first time, so there is a file to edit)
+    if (std::ifstream(archetypeFilePath)) {
+        archetypeTable.load(archetypeFilePath);
+    }
+    else {
+        archetypeTable.save(archetypeFilePath);
+    }
+
+    // Load shared assets once (Font, icon, sound effects) and show how long it took
+    ResourceManager::get().preload();
+    AudioMixer::preloadSoundBank();
+    ResourceManager::get().reportLoadTimes(std::cout);
+
+    {
+        Menu menu;
+        if (!replayFile.empty()) {
+            Replay replay;
+            if (replay.load(replayFile)) {
+                menu.runReplay(replay, (replaySpeed > 0.0f) ? replaySpeed : 1.0f);
+            }
+        }
+        menu.run();
+    }
+
+    // Every simulation thread has been joined with its game, stop the workers too before the trace is written
+    JobSystem::get().setThreadCount(0);
+    Tracer::stop();
 
     return 0;
 }
\ No newline at end of file
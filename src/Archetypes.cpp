@@ -0,0 +1,234 @@
+#include "Archetypes.h"
+#include "BinaryStream.h"
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+static const char* towerNames[TOWER_TYPE_COUNT] = { "Basic", "Rapid", "Sniper" };
+static const char* enemyNames[ENEMY_TYPE_COUNT] = { "Normal", "Fast", "Slow", "Boss" };
+
+ArchetypeTable::ArchetypeTable() {
+    // cost, range, damage, cooldown, radius, upgrade cost, upgrade damage, upgrade range, upgrade cooldown, color
+    towers[int(TowerType::Basic)] = { 100, 100.0f, 50, 1.0f, 20.0f, 100, 10, 20.0f, 0.9f, 0xff0000ff };
+    towers[int(TowerType::Rapid)] = { 150, 80.0f, 30, 0.5f, 15.0f, 100, 10, 20.0f, 0.9f, 0x00ff00ff };
+    towers[int(TowerType::Sniper)] = { 200, 150.0f, 100, 2.0f, 25.0f, 100, 10, 20.0f, 0.9f, 0x0000ffff };
+
+    // speed, health, circle, size, color
+    enemies[int(EnemyType::Normal)] = { 100.0f, 100, 1, 10.0f, 0xff0000ff };
+    enemies[int(EnemyType::Fast)] = { 200.0f, 50, 1, 5.0f, 0x00ffffff };
+    enemies[int(EnemyType::Slow)] = { 50.0f, 150, 0, 10.0f, 0x00ff00ff };
+    enemies[int(EnemyType::Boss)] = { 50.0f, 500, 1, 20.0f, 0xff00ffff };
+}
+
+const char* ArchetypeTable::towerName(TowerType type) {
+    return towerNames[int(type)];
+}
+
+const char* ArchetypeTable::enemyName(EnemyType type) {
+    return enemyNames[int(type)];
+}
+
+static bool readFile(const std::string& filename, std::string& text) {
+    std::ifstream file(filename);
+    if (!file) {
+        return false;
+    }
+    std::stringstream content;
+    content << file.rdbuf();
+    text = content.str();
+    return true;
+}
+
+bool ArchetypeTable::load(const std::string& filename) {
+    std::string text;
+    if (!readFile(filename, text)) {
+        std::cerr << "Cannot open " << filename << std::endl;
+        return false;
+    }
+    return parse(text, filename);
+}
+
+// "color r g b"
+static bool readColor(std::istream& line, std::uint32_t& color) {
+    int r, g, b;
+    if (!(line >> r >> g >> b) || r < 0 || r > 255 || g < 0 || g > 255 || b < 0 || b > 255) {
+        return false;
+    }
+    color = (std::uint32_t(r) << 24) | (std::uint32_t(g) << 16) | (std::uint32_t(b) << 8) | 0xff;
+    return true;
+}
+
+static bool readTowerKey(std::istream& line, const std::string& key, TowerArchetype& tower) {
+    if (key == "cost") return bool(line >> tower.cost) && tower.cost >= 0;
+    if (key == "range") return bool(line >> tower.range) && tower.range >= 0.0f;
+    if (key == "damage") return bool(line >> tower.damage);
+    if (key == "cooldown") return bool(line >> tower.attackCooldown) && tower.attackCooldown > 0.0f;
+    if (key == "radius") return bool(line >> tower.radius) && tower.radius > 0.0f;
+    if (key == "upgradeCost") return bool(line >> tower.upgradeCost) && tower.upgradeCost >= 0;
+    if (key == "upgradeDamage") return bool(line >> tower.upgradeDamage);
+    if (key == "upgradeRange") return bool(line >> tower.upgradeRange);
+    if (key == "upgradeCooldown") return bool(line >> tower.upgradeCooldown) && tower.upgradeCooldown > 0.0f;
+    if (key == "color") return readColor(line, tower.color);
+    return false;
+}
+
+static bool readEnemyKey(std::istream& line, const std::string& key, EnemyArchetype& enemy) {
+    if (key == "speed") return bool(line >> enemy.speed) && enemy.speed >= 0.0f;
+    if (key == "health") return bool(line >> enemy.health) && enemy.health > 0;
+    if (key == "size") return bool(line >> enemy.size) && enemy.size > 0.0f;
+    if (key == "color") return readColor(line, enemy.color);
+    if (key == "shape") {
+        std::string shape;
+        line >> shape;
+        enemy.circle = (shape == "circle") ? 1 : 0;
+        return shape == "circle" || shape == "square";
+    }
+    return false;
+}
+
+bool ArchetypeTable::parse(const std::string& text, const std::string& filename) {
+    ArchetypeTable parsed; // Keys not in the file get the built-in value, whatever was loaded before
+    std::istringstream lines(text);
+    std::string lineText;
+    int lineNumber = 0;
+
+    while (std::getline(lines, lineText)) {
+        lineNumber++;
+        std::istringstream line(lineText);
+        std::string kind, name;
+        if (!(line >> kind) || kind[0] == '#') {
+            continue; // Empty line or comment
+        }
+        line >> name;
+
+        int index = -1;
+        if (kind == "tower") {
+            for (int i = 0; i < TOWER_TYPE_COUNT; ++i) {
+                if (name == towerNames[i]) index = i;
+            }
+        }
+        else if (kind == "enemy") {
+            for (int i = 0; i < ENEMY_TYPE_COUNT; ++i) {
+                if (name == enemyNames[i]) index = i;
+            }
+        }
+        if (index < 0) {
+            std::cerr << filename << ":" << lineNumber << ": unknown " << kind << " " << name << std::endl;
+            return false;
+        }
+
+        std::string key;
+        while (line >> key) {
+            bool ok = (kind == "tower") ? readTowerKey(line, key, parsed.towers[index]) : readEnemyKey(line, key, parsed.enemies[index]);
+            if (!ok) {
+                std::cerr << filename << ":" << lineNumber << ": unknown key or bad value: " << key << std::endl;
+                return false;
+            }
+        }
+    }
+
+    *this = parsed;
+    return true;
+}
+
+bool ArchetypeTable::save(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file) {
+        std::cerr << "Cannot write " << filename << std::endl;
+        return false;
+    }
+    file << "# Tower and enemy stats, reloaded while the game runs\n";
+    file << "# Upgrading a tower of level n costs n * upgradeCost, cooldown is multiplied by upgradeCooldown\n";
+    for (int i = 0; i < TOWER_TYPE_COUNT; ++i) {
+        const TowerArchetype& tower = towers[i];
+        file << "tower " << towerNames[i] << " cost " << tower.cost << " range " << tower.range << " damage " << tower.damage
+            << " cooldown " << tower.attackCooldown << " radius " << tower.radius << " upgradeCost " << tower.upgradeCost
+            << " upgradeDamage " << tower.upgradeDamage << " upgradeRange " << tower.upgradeRange << " upgradeCooldown " << tower.upgradeCooldown
+            << " color " << (tower.color >> 24) << " " << ((tower.color >> 16) & 0xff) << " " << ((tower.color >> 8) & 0xff) << "\n";
+    }
+    for (int i = 0; i < ENEMY_TYPE_COUNT; ++i) {
+        const EnemyArchetype& enemy = enemies[i];
+        file << "enemy " << enemyNames[i] << " speed " << enemy.speed << " health " << enemy.health
+            << " shape " << (enemy.circle ? "circle" : "square") << " size " << enemy.size
+            << " color " << (enemy.color >> 24) << " " << ((enemy.color >> 16) & 0xff) << " " << ((enemy.color >> 8) & 0xff) << "\n";
+    }
+    return bool(file);
+}
+
+void ArchetypeTable::writeTo(BinaryWriter& writer) const {
+    for (const TowerArchetype& tower : towers) {
+        writer.write<std::int32_t>(tower.cost);
+        writer.write<float>(tower.range);
+        writer.write<std::int32_t>(tower.damage);
+        writer.write<float>(tower.attackCooldown);
+        writer.write<float>(tower.radius);
+        writer.write<std::int32_t>(tower.upgradeCost);
+        writer.write<std::int32_t>(tower.upgradeDamage);
+        writer.write<float>(tower.upgradeRange);
+        writer.write<float>(tower.upgradeCooldown);
+        writer.write<std::uint32_t>(tower.color);
+    }
+    for (const EnemyArchetype& enemy : enemies) {
+        writer.write<float>(enemy.speed);
+        writer.write<std::int32_t>(enemy.health);
+        writer.write<std::uint8_t>(enemy.circle);
+        writer.write<float>(enemy.size);
+        writer.write<std::uint32_t>(enemy.color);
+    }
+}
+
+// Same limits as the keys of the text file (Replays come from anywhere)
+static bool isValid(const TowerArchetype& tower) {
+    return tower.cost >= 0 && std::isfinite(tower.range) && tower.range >= 0.0f &&
+        std::isfinite(tower.attackCooldown) && tower.attackCooldown > 0.0f && std::isfinite(tower.radius) && tower.radius > 0.0f &&
+        tower.upgradeCost >= 0 && std::isfinite(tower.upgradeRange) && std::isfinite(tower.upgradeCooldown) && tower.upgradeCooldown > 0.0f;
+}
+
+static bool isValid(const EnemyArchetype& enemy) {
+    return std::isfinite(enemy.speed) && enemy.speed >= 0.0f && enemy.health > 0 &&
+        enemy.circle <= 1 && std::isfinite(enemy.size) && enemy.size > 0.0f;
+}
+
+bool ArchetypeTable::readFrom(BinaryReader& reader) {
+    for (TowerArchetype& tower : towers) {
+        tower.cost = reader.read<std::int32_t>();
+        tower.range = reader.read<float>();
+        tower.damage = reader.read<std::int32_t>();
+        tower.attackCooldown = reader.read<float>();
+        tower.radius = reader.read<float>();
+        tower.upgradeCost = reader.read<std::int32_t>();
+        tower.upgradeDamage = reader.read<std::int32_t>();
+        tower.upgradeRange = reader.read<float>();
+        tower.upgradeCooldown = reader.read<float>();
+        tower.color = reader.read<std::uint32_t>();
+        if (!isValid(tower)) {
+            return false;
+        }
+    }
+    for (EnemyArchetype& enemy : enemies) {
+        enemy.speed = reader.read<float>();
+        enemy.health = reader.read<std::int32_t>();
+        enemy.circle = reader.read<std::uint8_t>();
+        enemy.size = reader.read<float>();
+        enemy.color = reader.read<std::uint32_t>();
+        if (!isValid(enemy)) {
+            return false;
+        }
+    }
+    return reader.isOk();
+}
+
+ArchetypeWatcher::ArchetypeWatcher(const std::string& filename) : filename(filename) {
+    readFile(filename, lastText);
+}
+
+bool ArchetypeWatcher::poll(ArchetypeTable& table) {
+    std::string text;
+    if (!readFile(filename, text) || text == lastText) {
+        return false;
+    }
+    lastText = text;
+    return table.parse(text, filename); // A file saved halfway is reported once, then read again when it changes
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "EnemyPool.h"
+#include "Targeting.h"
+
+// Stats of every tower and enemy type (Loaded from a text file, so balancing needs no recompile)
+/*
+* The stats are flat tables indexed by the type id: the simulation reads
+* archetypes.enemies[int(type)].speed instead of going through a switch, and the table is
+* plain memory that can be copied between threads or written into a replay as it is.
+*
+* File ("Game File/Archetypes.txt", created with the built-in stats if it does not exist):
+*   # Comment
+*   tower Basic cost 100 range 100 damage 50 cooldown 1 radius 20 upgradeCost 100 upgradeDamage 10 upgradeRange 20 upgradeCooldown 0.9 color 255 0 0
+*   enemy Fast speed 200 health 50 shape circle size 5 color 0 255 255
+* Keys can be left out or come in any order (The built-in value is kept), unknown keys are errors.
+*
+* How to use:
+* ArchetypeTable archetypes;                        // Built-in stats
+* archetypes.load("Game File/Archetypes.txt");       // Keeps the old stats if the file is wrong
+* ArchetypeWatcher watcher("Game File/Archetypes.txt");
+* if (watcher.poll(archetypes)) {...}               // Once in a while, true when the file changed
+*/
+struct TowerArchetype {
+    int cost;
+    float range;
+    int damage;
+    float attackCooldown;   // Seconds between two shots
+    float radius;           // Size of the tower on the playfield
+    int upgradeCost;        // Upgrading a tower of level n costs n * upgradeCost
+    int upgradeDamage;      // Added by every upgrade
+    float upgradeRange;     // Added by every upgrade
+    float upgradeCooldown;  // Cooldown is multiplied by it on every upgrade
+    std::uint32_t color;    // 0xRRGGBBAA (Same as sf::Color::toInteger)
+};
+
+struct EnemyArchetype {
+    float speed;
+    int health;
+    std::uint8_t circle;    // 1 = circle, 0 = square
+    float size;             // Radius of a circle, half side of a square
+    std::uint32_t color;
+};
+
+struct ArchetypeTable {
+    TowerArchetype towers[TOWER_TYPE_COUNT];
+    EnemyArchetype enemies[ENEMY_TYPE_COUNT];
+
+    // Built-in stats
+    ArchetypeTable();
+
+    const TowerArchetype& tower(TowerType type) const { return towers[int(type)]; }
+    const EnemyArchetype& enemy(EnemyType type) const { return enemies[int(type)]; }
+
+    // Return false (And keep the current stats) if the file cannot be read or has an error
+    bool load(const std::string& filename);
+    bool parse(const std::string& text, const std::string& filename);
+    bool save(const std::string& filename) const;
+
+    // Binary copy for replays (Every field, in order)
+    void writeTo(BinaryWriter& writer) const;
+    // Return false if the data is damaged or a value is out of the limits of the text file
+    bool readFrom(BinaryReader& reader);
+
+    static const char* towerName(TowerType type);
+    static const char* enemyName(EnemyType type);
+};
+
+// Reload the table when its file was edited (Compares the text, the file is only a few lines)
+class ArchetypeWatcher {
+private:
+    std::string filename;
+    std::string lastText;
+
+public:
+    // The file as it is now counts as already loaded
+    explicit ArchetypeWatcher(const std::string& filename);
+
+    // Return true if the file changed and the new stats were loaded into table
+    bool poll(ArchetypeTable& table);
+};
@@ -0,0 +1,101 @@
+#include "AudioMixer.h"
+#include "rss_Manager.h"
+
+AudioMixer& AudioMixer::get() {
+    static AudioMixer mixer;
+    return mixer;
+}
+
+AudioMixer::AudioMixer() : voices(VOICE_COUNT), playCounter(0) {
+    categoryLimit[int(SoundCategory::TowerShot)] = 16;
+    categoryLimit[int(SoundCategory::Effect)] = 12;
+    categoryLimit[int(SoundCategory::Music)] = 4;
+}
+
+VoiceHandle AudioMixer::play(SoundCategory category, const std::string& filename, float volume, float pitch, bool loop) {
+    int index = pickVoice(category);
+    Voice& voice = voices[index];
+
+    voice.sound.stop();
+    voice.generation++; // Old handles of this voice become invalid
+    voice.category = category;
+    voice.startOrder = ++playCounter;
+
+    //Associate a sound buffer to the sound object
+    voice.sound.setBuffer(ResourceManager::get().getSoundBuffer(filename));
+
+    // Audio Setting
+    voice.sound.setPitch(pitch);
+    voice.sound.setVolume(volume);
+    voice.sound.setLoop(loop);
+    voice.sound.play();
+
+    VoiceHandle handle;
+    handle.voice = index;
+    handle.generation = voice.generation;
+    return handle;
+}
+
+sf::Sound* AudioMixer::find(VoiceHandle handle) {
+    if (handle.voice < 0 || voices[handle.voice].generation != handle.generation) {
+        return nullptr;
+    }
+    return &voices[handle.voice].sound;
+}
+
+void AudioMixer::setCategoryLimit(SoundCategory category, int limit) {
+    categoryLimit[int(category)] = (limit < 1) ? 1 : limit;
+}
+
+int AudioMixer::pickVoice(SoundCategory category) {
+    int sameCategoryCount = 0;
+    int oldestSameCategory = -1;
+    int oldestOther = -1;
+    int freeVoice = -1;
+
+    for (int i = 0; i < int(voices.size()); ++i) {
+        const Voice& voice = voices[i];
+        if (voice.sound.getStatus() == sf::Sound::Stopped) {
+            if (freeVoice < 0) {
+                freeVoice = i;
+            }
+            continue;
+        }
+        if (voice.category == category) {
+            sameCategoryCount++;
+            if (oldestSameCategory < 0 || voice.startOrder < voices[oldestSameCategory].startOrder) {
+                oldestSameCategory = i;
+            }
+        }
+        else if (voice.category != SoundCategory::Music) {
+            if (oldestOther < 0 || voice.startOrder < voices[oldestOther].startOrder) {
+                oldestOther = i;
+            }
+        }
+    }
+
+    // Category is full: replace its oldest sound
+    if (sameCategoryCount >= categoryLimit[int(category)] && oldestSameCategory >= 0) {
+        return oldestSameCategory;
+    }
+    if (freeVoice >= 0) {
+        return freeVoice;
+    }
+    // Every voice is busy: replace the oldest sound that is not music (Or of the same category)
+    if (category != SoundCategory::Music && oldestOther >= 0 &&
+        (oldestSameCategory < 0 || voices[oldestOther].startOrder < voices[oldestSameCategory].startOrder)) {
+        return oldestOther;
+    }
+    return (oldestSameCategory >= 0) ? oldestSameCategory : ((oldestOther >= 0) ? oldestOther : 0);
+}
+
+void AudioMixer::preloadSoundBank() {
+    const char* soundEffects[] = {
+        "ArrowShoot1.wav", "ArrowShoot2.wav", "Building1.wav", "Building2.wav",
+        "CannotPlaceHere.wav", "GameOver.wav", "GetMoney.wav", "LooseLife.wav",
+        "NotEnoughMoney.wav", "Pause.wav", "SelectSound.wav", "Upgrade1.wav"
+    };
+    for (const char* filename : soundEffects) {
+        ResourceManager::get().getSoundBuffer(filename);
+    }
+}
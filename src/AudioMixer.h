@@ -0,0 +1,59 @@
+#pragma once
+
+#include <SFML/Audio.hpp>
+
+#include <string>
+#include <vector>
+
+// What a sound is used for (Each kind has its own limit of voices)
+enum class SoundCategory { TowerShot, Effect, Music };
+const int SOUND_CATEGORY_COUNT = 3;
+
+// Number of sf::Sound objects shared by the whole game
+const int VOICE_COUNT = 32;
+
+// Refer to the voice playing a sound (Invalid once the voice is given to another sound)
+struct VoiceHandle {
+    int voice = -1;
+    unsigned int generation = 0;
+};
+
+// Audio mixer (Fixed pool of voices shared by every SoundPlayer)
+/*
+* Sound buffers come from the ResourceManager, so a file is decoded only the first time it
+* is played (Or at startup for the sounds in preloadSoundBank()).
+* When a category already plays as many sounds as its limit, or every voice is busy, the
+* oldest sound is stopped and its voice reused (Music is only stolen by music).
+*/
+class AudioMixer {
+public:
+    static AudioMixer& get();
+
+    // Start a sound on a free (or stolen) voice
+    VoiceHandle play(SoundCategory category, const std::string& filename, float volume, float pitch, bool loop);
+
+    // Sound of the handle, nullptr if the voice was given to another sound
+    sf::Sound* find(VoiceHandle handle);
+
+    void setCategoryLimit(SoundCategory category, int limit);
+
+    // Decode every sound effect now so the first shot does not hitch
+    static void preloadSoundBank();
+
+private:
+    AudioMixer();
+    AudioMixer(const AudioMixer&) = delete;
+    AudioMixer& operator=(const AudioMixer&) = delete;
+
+    int pickVoice(SoundCategory category);
+
+    struct Voice {
+        sf::Sound sound;
+        SoundCategory category = SoundCategory::Effect;
+        unsigned int generation = 0;
+        unsigned long long startOrder = 0; // When the sound started, used to find the oldest one
+    };
+    std::vector<Voice> voices;
+    int categoryLimit[SOUND_CATEGORY_COUNT];
+    unsigned long long playCounter;
+};
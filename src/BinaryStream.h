@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Little helpers to write and read binary files (Replays, saves, caches)
+/*
+* Numbers are stored as they are in memory (Little endian on every machine the game runs on).
+* Arrays of plain numbers are copied in one memcpy, so big arrays load at memory speed.
+* writeArray(values, 8) starts the elements at a multiple of 8 bytes from the start of the file,
+* so they can also be used in place (E.g. from a memory mapped file) without copying.
+*
+* How to use:
+* BinaryWriter writer;
+* writer.write<std::uint32_t>(magic); writer.writeArray(enemies.positionX);
+* writer.saveTo("file.bin");
+*
+* BinaryReader reader;
+* if (!reader.loadFrom("file.bin")) {...}
+* std::uint32_t magic = reader.read<std::uint32_t>(); reader.readArray(positionX);
+* if (!reader.isOk()) {...}   // Set to false as soon as something was read past the end
+*/
+class BinaryWriter {
+private:
+    std::vector<std::uint8_t> bytes;
+
+public:
+    template <typename T>
+    void write(T value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be written");
+        std::size_t offset = bytes.size();
+        bytes.resize(offset + sizeof(T));
+        std::memcpy(&bytes[offset], &value, sizeof(T));
+    }
+
+    // Unsigned number in 1 to 10 bytes (Small numbers take less space)
+    void writeVarint(std::uint64_t value) {
+        while (value >= 0x80) {
+            bytes.push_back(std::uint8_t(value) | 0x80);
+            value >>= 7;
+        }
+        bytes.push_back(std::uint8_t(value));
+    }
+
+    // Zero bytes until the size is a multiple of alignment
+    void align(std::size_t alignment) {
+        bytes.resize((bytes.size() + alignment - 1) / alignment * alignment, 0);
+    }
+
+    // Element count followed by the elements (Which start at a multiple of alignment)
+    template <typename T>
+    void writeArray(const std::vector<T>& values, std::size_t alignment = 1) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be written");
+        write<std::uint32_t>(std::uint32_t(values.size()));
+        align(alignment);
+        if (!values.empty()) {
+            std::size_t offset = bytes.size();
+            bytes.resize(offset + values.size() * sizeof(T));
+            std::memcpy(&bytes[offset], values.data(), values.size() * sizeof(T));
+        }
+    }
+
+    // Length followed by the characters
+    void writeString(const std::string& text) {
+        writeVarint(text.size());
+        bytes.insert(bytes.end(), text.begin(), text.end());
+    }
+
+    const std::vector<std::uint8_t>& getBytes() const { return bytes; }
+
+    bool saveTo(const std::string& filename) const {
+        std::ofstream file(filename, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+        return bool(file);
+    }
+};
+
+class BinaryReader {
+private:
+    std::vector<std::uint8_t> bytes;
+    std::size_t position;
+    bool ok;
+
+    bool canRead(std::size_t size) {
+        if (!ok || bytes.size() - position < size) {
+            ok = false;
+        }
+        return ok;
+    }
+
+public:
+    BinaryReader() : position(0), ok(true) {}
+    explicit BinaryReader(std::vector<std::uint8_t> data) : bytes(std::move(data)), position(0), ok(true) {}
+
+    bool loadFrom(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return false;
+        }
+        bytes.resize(std::size_t(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(bytes.data()), std::streamsize(bytes.size()));
+        position = 0;
+        ok = bool(file);
+        return ok;
+    }
+
+    // Return T() when reading past the end
+    template <typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be read");
+        T value = T();
+        if (canRead(sizeof(T))) {
+            std::memcpy(&value, &bytes[position], sizeof(T));
+            position += sizeof(T);
+        }
+        return value;
+    }
+
+    std::uint64_t readVarint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64 && canRead(1); shift += 7) {
+            std::uint8_t byte = bytes[position++];
+            value |= std::uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    // Skip the padding written by BinaryWriter::align
+    void align(std::size_t alignment) {
+        std::size_t aligned = (position + alignment - 1) / alignment * alignment;
+        if (canRead(aligned - position)) {
+            position = aligned;
+        }
+    }
+
+    // Same alignment as the writeArray call that wrote it
+    template <typename T>
+    void readArray(std::vector<T>& values, std::size_t alignment = 1) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be read");
+        std::uint32_t count = read<std::uint32_t>();
+        align(alignment);
+        if (!canRead(std::size_t(count) * sizeof(T))) {
+            values.clear();
+            return;
+        }
+        values.resize(count);
+        if (count > 0) {
+            std::memcpy(values.data(), &bytes[position], std::size_t(count) * sizeof(T));
+            position += std::size_t(count) * sizeof(T);
+        }
+    }
+
+    std::string readString() {
+        std::uint64_t length = readVarint();
+        if (!canRead(std::size_t(length))) {
+            return std::string();
+        }
+        std::string text(reinterpret_cast<const char*>(bytes.data()) + position, std::size_t(length));
+        position += std::size_t(length);
+        return text;
+    }
+
+    bool isOk() const { return ok; }
+    bool atEnd() const { return position >= bytes.size(); }
+};
@@ -0,0 +1,87 @@
+#include "BulletPool.h"
+#include "BinaryStream.h"
+
+BulletPool::BulletPool(std::size_t capacity) : maxBullets(capacity) {
+    positionX.reserve(capacity);
+    positionY.reserve(capacity);
+    previousX.reserve(capacity);
+    previousY.reserve(capacity);
+    velocityX.reserve(capacity);
+    velocityY.reserve(capacity);
+    damage.reserve(capacity);
+}
+
+bool BulletPool::add(float x, float y, float vx, float vy, int bulletDamage) {
+    if (full()) {
+        return false;
+    }
+    positionX.push_back(x);
+    positionY.push_back(y);
+    previousX.push_back(x);
+    previousY.push_back(y);
+    velocityX.push_back(vx);
+    velocityY.push_back(vy);
+    damage.push_back(bulletDamage);
+    return true;
+}
+
+void BulletPool::remove(std::size_t index) {
+    std::size_t last = size() - 1;
+    if (index != last) {
+        positionX[index] = positionX[last];
+        positionY[index] = positionY[last];
+        previousX[index] = previousX[last];
+        previousY[index] = previousY[last];
+        velocityX[index] = velocityX[last];
+        velocityY[index] = velocityY[last];
+        damage[index] = damage[last];
+    }
+    positionX.pop_back();
+    positionY.pop_back();
+    previousX.pop_back();
+    previousY.pop_back();
+    velocityX.pop_back();
+    velocityY.pop_back();
+    damage.pop_back();
+}
+
+void BulletPool::clear() {
+    positionX.clear();
+    positionY.clear();
+    previousX.clear();
+    previousY.clear();
+    velocityX.clear();
+    velocityY.clear();
+    damage.clear();
+}
+
+// Arrays start at a multiple of 8 bytes (See BinaryStream.h)
+void BulletPool::writeTo(BinaryWriter& writer) const {
+    writer.writeArray(positionX, 8);
+    writer.writeArray(positionY, 8);
+    writer.writeArray(previousX, 8);
+    writer.writeArray(previousY, 8);
+    writer.writeArray(velocityX, 8);
+    writer.writeArray(velocityY, 8);
+    writer.writeArray(damage, 8);
+}
+
+bool BulletPool::readFrom(BinaryReader& reader) {
+    // Memory reserved in the constructor is kept (resize never shrinks it)
+    reader.readArray(positionX, 8);
+    reader.readArray(positionY, 8);
+    reader.readArray(previousX, 8);
+    reader.readArray(previousY, 8);
+    reader.readArray(velocityX, 8);
+    reader.readArray(velocityY, 8);
+    reader.readArray(damage, 8);
+
+    std::size_t count = size();
+    if (!reader.isOk() || count > maxBullets ||
+        positionY.size() != count || previousX.size() != count || previousY.size() != count ||
+        velocityX.size() != count || velocityY.size() != count || damage.size() != count) {
+        clear();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+class BinaryWriter;
+class BinaryReader;
+
+// Storage of every bullet in the match (Struct of arrays, fixed capacity)
+/*
+* All the memory is reserved when the pool is created, so firing never allocates.
+* Removing a bullet moves the last bullet into its index (Swap and pop).
+*/
+class BulletPool {
+public:
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> previousX;  // Position at the start of the last tick (For drawing between ticks)
+    std::vector<float> previousY;
+    std::vector<float> velocityX;
+    std::vector<float> velocityY;
+    std::vector<int> damage;
+
+    explicit BulletPool(std::size_t capacity);
+
+    // Add a bullet, return false if the pool is full
+    bool add(float x, float y, float vx, float vy, int bulletDamage);
+
+    // Remove the bullet at index (The last bullet takes its index)
+    void remove(std::size_t index);
+
+    void clear();
+
+    // Every array as it is (The capacity does not change)
+    void writeTo(BinaryWriter& writer) const;
+    // Return false (And leave the pool empty) if the data is damaged or has more bullets than the capacity
+    bool readFrom(BinaryReader& reader);
+
+    std::size_t size() const { return positionX.size(); }
+    std::size_t capacity() const { return maxBullets; }
+    bool full() const { return size() >= maxBullets; }
+
+private:
+    std::size_t maxBullets;
+};
@@ -0,0 +1,188 @@
+#include "EnemyPool.h"
+#include "BinaryStream.h"
+
+EnemyHandle EnemyPool::add(EnemyType enemyType, std::uint16_t enemyPath, float x, float y, float enemySpeed, int enemyHealth) {
+    // Reuse a slot of a removed enemy if there is one
+    std::uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        slot = std::uint32_t(slotToIndex.size());
+        slotToIndex.push_back(0);
+        slotGeneration.push_back(0);
+    }
+    slotToIndex[slot] = std::uint32_t(size());
+    indexToSlot.push_back(slot);
+
+    positionX.push_back(x);
+    positionY.push_back(y);
+    previousX.push_back(x);
+    previousY.push_back(y);
+    speed.push_back(enemySpeed);
+    health.push_back(enemyHealth);
+    maxHealth.push_back(enemyHealth);
+    path.push_back(enemyPath);
+    distance.push_back(0.0f);
+    segment.push_back(0);
+    type.push_back(enemyType);
+    alive.push_back(1);
+    hit.push_back(0);
+
+    EnemyHandle handle;
+    handle.slot = slot;
+    handle.generation = slotGeneration[slot];
+    return handle;
+}
+
+void EnemyPool::remove(std::size_t index) {
+    std::size_t last = size() - 1;
+
+    // Old handles of this enemy become invalid
+    std::uint32_t removedSlot = indexToSlot[index];
+    slotGeneration[removedSlot]++;
+    freeSlots.push_back(removedSlot);
+
+    if (index != last) {
+        positionX[index] = positionX[last];
+        positionY[index] = positionY[last];
+        previousX[index] = previousX[last];
+        previousY[index] = previousY[last];
+        speed[index] = speed[last];
+        health[index] = health[last];
+        maxHealth[index] = maxHealth[last];
+        path[index] = path[last];
+        distance[index] = distance[last];
+        segment[index] = segment[last];
+        type[index] = type[last];
+        alive[index] = alive[last];
+        hit[index] = hit[last];
+
+        indexToSlot[index] = indexToSlot[last];
+        slotToIndex[indexToSlot[index]] = std::uint32_t(index);
+    }
+
+    positionX.pop_back();
+    positionY.pop_back();
+    previousX.pop_back();
+    previousY.pop_back();
+    speed.pop_back();
+    health.pop_back();
+    maxHealth.pop_back();
+    path.pop_back();
+    distance.pop_back();
+    segment.pop_back();
+    type.pop_back();
+    alive.pop_back();
+    hit.pop_back();
+    indexToSlot.pop_back();
+}
+
+void EnemyPool::clear() {
+    while (!empty()) {
+        remove(size() - 1);
+    }
+}
+
+void EnemyPool::reserve(std::size_t capacity) {
+    positionX.reserve(capacity);
+    positionY.reserve(capacity);
+    previousX.reserve(capacity);
+    previousY.reserve(capacity);
+    speed.reserve(capacity);
+    health.reserve(capacity);
+    maxHealth.reserve(capacity);
+    path.reserve(capacity);
+    distance.reserve(capacity);
+    segment.reserve(capacity);
+    type.reserve(capacity);
+    alive.reserve(capacity);
+    hit.reserve(capacity);
+    indexToSlot.reserve(capacity);
+}
+
+EnemyHandle EnemyPool::handleAt(std::size_t index) const {
+    EnemyHandle handle;
+    handle.slot = indexToSlot[index];
+    handle.generation = slotGeneration[handle.slot];
+    return handle;
+}
+
+bool EnemyPool::contains(EnemyHandle handle) const {
+    return handle.slot < slotGeneration.size() && slotGeneration[handle.slot] == handle.generation;
+}
+
+// Arrays start at a multiple of 8 bytes (See BinaryStream.h)
+void EnemyPool::writeTo(BinaryWriter& writer) const {
+    writer.writeArray(positionX, 8);
+    writer.writeArray(positionY, 8);
+    writer.writeArray(previousX, 8);
+    writer.writeArray(previousY, 8);
+    writer.writeArray(speed, 8);
+    writer.writeArray(health, 8);
+    writer.writeArray(maxHealth, 8);
+    writer.writeArray(path, 8);
+    writer.writeArray(distance, 8);
+    writer.writeArray(segment, 8);
+    writer.writeArray(type, 8);
+    writer.writeArray(alive, 8);
+    writer.writeArray(hit, 8);
+    writer.writeArray(indexToSlot, 8);
+    writer.writeArray(slotToIndex, 8);
+    writer.writeArray(slotGeneration, 8);
+    writer.writeArray(freeSlots, 8);
+}
+
+bool EnemyPool::readFrom(BinaryReader& reader) {
+    reader.readArray(positionX, 8);
+    reader.readArray(positionY, 8);
+    reader.readArray(previousX, 8);
+    reader.readArray(previousY, 8);
+    reader.readArray(speed, 8);
+    reader.readArray(health, 8);
+    reader.readArray(maxHealth, 8);
+    reader.readArray(path, 8);
+    reader.readArray(distance, 8);
+    reader.readArray(segment, 8);
+    reader.readArray(type, 8);
+    reader.readArray(alive, 8);
+    reader.readArray(hit, 8);
+    reader.readArray(indexToSlot, 8);
+    reader.readArray(slotToIndex, 8);
+    reader.readArray(slotGeneration, 8);
+    reader.readArray(freeSlots, 8);
+    if (!reader.isOk()) {
+        return false;
+    }
+
+    // Every array has one value per enemy, every enemy owns a slot that points back to it
+    std::size_t count = size();
+    if (positionY.size() != count || previousX.size() != count || previousY.size() != count ||
+        speed.size() != count || health.size() != count || maxHealth.size() != count ||
+        path.size() != count || distance.size() != count || segment.size() != count ||
+        type.size() != count || alive.size() != count || hit.size() != count ||
+        indexToSlot.size() != count || slotToIndex.size() != slotGeneration.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        if (indexToSlot[i] >= slotToIndex.size() || slotToIndex[indexToSlot[i]] != i || type[i] > EnemyType::Boss) {
+            return false;
+        }
+    }
+    // Every other slot is free exactly once, or add() would give a slot to two enemies
+    if (freeSlots.size() + count != slotToIndex.size()) {
+        return false;
+    }
+    std::vector<std::uint8_t> slotUsed(slotToIndex.size(), 0);
+    for (std::size_t i = 0; i < count; ++i) {
+        slotUsed[indexToSlot[i]] = 1;
+    }
+    for (std::uint32_t slot : freeSlots) {
+        if (slot >= slotToIndex.size() || slotUsed[slot]) {
+            return false;
+        }
+        slotUsed[slot] = 1;
+    }
+    return true;
+}
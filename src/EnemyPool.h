@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class BinaryWriter;
+class BinaryReader;
+
+// Enemy kinds (Decide speed, health and how they are drawn)
+enum class EnemyType : std::uint8_t { Normal, Fast, Slow, Boss };
+const int ENEMY_TYPE_COUNT = 4;
+
+// Refer to one enemy even after other enemies were removed (Index changes, handle does not)
+struct EnemyHandle {
+    std::uint32_t slot = 0;
+    std::uint32_t generation = 0; // Bumped every time the slot is reused, so old handles become invalid
+};
+
+// Enemy storage (Struct of arrays)
+/*
+* Every field of the enemies is stored in its own contiguous array, the enemy with index i
+* is positionX[i], positionY[i], health[i], ...
+* Removing an enemy moves the last enemy into its place (Swap and pop), so the order of the
+* enemies is not kept. Use an EnemyHandle to find an enemy again after removals.
+*/
+class EnemyPool {
+public:
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> previousX;         // Position at the start of the last tick (For drawing between ticks)
+    std::vector<float> previousY;
+    std::vector<float> speed;
+    std::vector<int> health;
+    std::vector<int> maxHealth;
+    std::vector<std::uint16_t> path;      // PathId of the path the enemy walks on
+    std::vector<float> distance;          // How far along the path the enemy has walked
+    std::vector<std::uint32_t> segment;   // Segment of the path the enemy is on (Only used to find its position faster)
+    std::vector<EnemyType> type;
+    std::vector<std::uint8_t> alive;      // Set to 0 when killed, removed at the end of the tick
+    std::vector<std::uint8_t> hit;        // Received damage at least once (Drawn in white)
+
+    // Add an enemy at the end of the arrays
+    EnemyHandle add(EnemyType enemyType, std::uint16_t enemyPath, float x, float y, float enemySpeed, int enemyHealth);
+
+    // Remove the enemy at index (The last enemy takes its index)
+    void remove(std::size_t index);
+
+    void clear();
+    void reserve(std::size_t capacity);
+
+    std::size_t size() const { return positionX.size(); }
+    bool empty() const { return positionX.empty(); }
+
+    // Handle of the enemy currently at index
+    EnemyHandle handleAt(std::size_t index) const;
+
+    // Return false if the enemy of the handle was removed
+    bool contains(EnemyHandle handle) const;
+
+    // Current index of the enemy (Check contains() first)
+    std::size_t indexOf(EnemyHandle handle) const { return slotToIndex[handle.slot]; }
+
+    // Every array as it is, handles saved before are still valid after readFrom()
+    void writeTo(BinaryWriter& writer) const;
+    // Return false (And leave the pool unusable) if the data is damaged
+    bool readFrom(BinaryReader& reader);
+
+private:
+    std::vector<std::uint32_t> indexToSlot;
+    std::vector<std::uint32_t> slotToIndex;
+    std::vector<std::uint32_t> slotGeneration;
+    std::vector<std::uint32_t> freeSlots;
+};
@@ -0,0 +1,123 @@
+#include "EntityBatch.h"
+
+#include <cmath>
+
+// Points used to draw a circle (SFML uses 30, enemies and bullets are small)
+const int CIRCLE_SEGMENTS = 16;
+
+// Vertices of one HP bar (Two rectangles of two triangles)
+const std::size_t HEALTH_BAR_VERTICES = 12;
+
+EntityBatch::EntityBatch()
+    : enemyVertices(sf::Triangles), healthBarVertices(sf::Triangles), bulletVertices(sf::Triangles), hideFullHealthBars(false) {
+    setLooks(ArchetypeTable());
+
+    const float pi = 3.14159265f;
+    for (int i = 0; i <= CIRCLE_SEGMENTS; ++i) {
+        float angle = 2.0f * pi * i / CIRCLE_SEGMENTS;
+        unitCircle.push_back(sf::Vector2f(std::cos(angle), std::sin(angle)));
+    }
+}
+
+void EntityBatch::setLooks(const ArchetypeTable& archetypes) {
+    for (int i = 0; i < ENEMY_TYPE_COUNT; ++i) {
+        const EnemyArchetype& enemy = archetypes.enemies[i];
+        enemyLooks[i] = { enemy.circle != 0, enemy.size, sf::Color(enemy.color) };
+    }
+}
+
+void EntityBatch::buildEnemies(const EnemyPool& enemies, float alpha) {
+    enemyVertices.clear(); // Keeps its memory, so no allocation once the array is big enough
+
+    for (std::size_t i = 0; i < enemies.size(); ++i) {
+        sf::Vector2f position(
+            enemies.previousX[i] + (enemies.positionX[i] - enemies.previousX[i]) * alpha,
+            enemies.previousY[i] + (enemies.positionY[i] - enemies.previousY[i]) * alpha);
+        const EnemyLook& look = enemyLooks[int(enemies.type[i])];
+
+        // Change color when receiving damage
+        sf::Color color = enemies.hit[i] ? sf::Color::White : look.color;
+        if (look.circle) {
+            appendCircle(enemyVertices, position, look.size, color);
+        }
+        else {
+            appendRect(enemyVertices, position.x - look.size, position.y - look.size, look.size * 2, look.size * 2, color);
+        }
+    }
+}
+
+void EntityBatch::buildHealthBars(const EnemyPool& enemies, float alpha) {
+    std::size_t count = enemies.size();
+    if (barHealth.size() != count) {
+        healthBarVertices.resize(count * HEALTH_BAR_VERTICES);
+        barPosition.resize(count);
+        barHealth.resize(count, -2.0f); // Never a real value, so new indices are written
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        // HP bar follows the enemy and shrinks with its health (30x5, centered 20 above the enemy)
+        sf::Vector2f position(
+            enemies.previousX[i] + (enemies.positionX[i] - enemies.previousX[i]) * alpha - 15.0f,
+            enemies.previousY[i] + (enemies.positionY[i] - enemies.previousY[i]) * alpha - 20.0f - 2.5f);
+        bool hidden = hideFullHealthBars && enemies.health[i] >= enemies.maxHealth[i];
+        float hpPercent = hidden ? -1.0f : static_cast<float>(enemies.health[i]) / enemies.maxHealth[i];
+
+        if (hpPercent == barHealth[i] && (hidden || position == barPosition[i])) {
+            continue; // Same bar as last frame
+        }
+        barHealth[i] = hpPercent;
+        barPosition[i] = position;
+
+        std::size_t first = i * HEALTH_BAR_VERTICES;
+        if (hidden) {
+            // Zero size triangles draw nothing
+            for (std::size_t v = first; v < first + HEALTH_BAR_VERTICES; ++v) {
+                healthBarVertices[v] = sf::Vertex(sf::Vector2f(0.0f, 0.0f), sf::Color::Transparent);
+            }
+        }
+        else {
+            setRect(healthBarVertices, first, position.x, position.y, 30.0f, 5.0f, sf::Color::Black);
+            setRect(healthBarVertices, first + 6, position.x, position.y, 30.0f * hpPercent, 5.0f, sf::Color::Red);
+        }
+    }
+}
+
+void EntityBatch::buildBullets(const BulletPool& bullets, float alpha) {
+    bulletVertices.clear();
+    for (std::size_t i = 0; i < bullets.size(); ++i) {
+        sf::Vector2f position(
+            bullets.previousX[i] + (bullets.positionX[i] - bullets.previousX[i]) * alpha,
+            bullets.previousY[i] + (bullets.positionY[i] - bullets.previousY[i]) * alpha);
+        appendCircle(bulletVertices, position, 5.0f, sf::Color::Yellow);
+    }
+}
+
+void EntityBatch::appendCircle(sf::VertexArray& vertices, sf::Vector2f center, float radius, sf::Color color) const {
+    for (int i = 0; i < CIRCLE_SEGMENTS; ++i) {
+        vertices.append(sf::Vertex(center, color));
+        vertices.append(sf::Vertex(center + unitCircle[i] * radius, color));
+        vertices.append(sf::Vertex(center + unitCircle[i + 1] * radius, color));
+    }
+}
+
+void EntityBatch::setRect(sf::VertexArray& vertices, std::size_t first, float left, float top, float width, float height, sf::Color color) const {
+    sf::Vector2f topLeft(left, top), topRight(left + width, top);
+    sf::Vector2f bottomLeft(left, top + height), bottomRight(left + width, top + height);
+    vertices[first] = sf::Vertex(topLeft, color);
+    vertices[first + 1] = sf::Vertex(topRight, color);
+    vertices[first + 2] = sf::Vertex(bottomRight, color);
+    vertices[first + 3] = sf::Vertex(topLeft, color);
+    vertices[first + 4] = sf::Vertex(bottomRight, color);
+    vertices[first + 5] = sf::Vertex(bottomLeft, color);
+}
+
+void EntityBatch::appendRect(sf::VertexArray& vertices, float left, float top, float width, float height, sf::Color color) const {
+    sf::Vector2f topLeft(left, top), topRight(left + width, top);
+    sf::Vector2f bottomLeft(left, top + height), bottomRight(left + width, top + height);
+    vertices.append(sf::Vertex(topLeft, color));
+    vertices.append(sf::Vertex(topRight, color));
+    vertices.append(sf::Vertex(bottomRight, color));
+    vertices.append(sf::Vertex(topLeft, color));
+    vertices.append(sf::Vertex(bottomRight, color));
+    vertices.append(sf::Vertex(bottomLeft, color));
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <vector>
+
+#include "EnemyPool.h"
+#include "BulletPool.h"
+#include "Archetypes.h"
+
+// Batched drawing of enemies, HP bars and bullets
+/*
+* Instead of one window.draw per shape, every frame the shapes are written as triangles into
+* one sf::VertexArray, which is drawn with a single call.
+* HP bars are kept from frame to frame: the bar of an enemy is only written again when its
+* position or health changed (So nothing is written while the game is paused).
+*
+* How to use:
+* batch.buildEnemies(simulation.getEnemies(), alpha);
+* batch.buildHealthBars(simulation.getEnemies(), alpha);
+* batch.drawEnemies(window);
+* batch.drawHealthBars(window);
+*/
+class EntityBatch {
+private:
+    // How every enemy type looks (Indexed by EnemyType)
+    struct EnemyLook {
+        bool circle;     // Circle or square
+        float size;      // Radius of a circle, half side of a square
+        sf::Color color;
+    };
+    EnemyLook enemyLooks[ENEMY_TYPE_COUNT];
+
+    sf::VertexArray enemyVertices;
+    sf::VertexArray healthBarVertices;    // 12 vertices per enemy (Background and health), same index as the enemy
+    sf::VertexArray bulletVertices;
+
+    // What the HP bar of every enemy index shows now
+    std::vector<sf::Vector2f> barPosition;
+    std::vector<float> barHealth;         // Fraction of max health, -1 when the bar is hidden
+    bool hideFullHealthBars;
+    std::vector<sf::Vector2f> unitCircle; // Points of a circle of radius 1 (First point repeated at the end)
+
+public:
+    EntityBatch();
+
+    // Shape, size and color of every enemy type
+    void setLooks(const ArchetypeTable& archetypes);
+
+    // Enemy shapes
+    // alpha: how far between the previous tick (0) and the current tick (1) to draw them
+    void buildEnemies(const EnemyPool& enemies, float alpha = 1.0f);
+    void buildHealthBars(const EnemyPool& enemies, float alpha = 1.0f);
+    void buildBullets(const BulletPool& bullets, float alpha = 1.0f);
+
+    // Do not draw the HP bar of enemies that were not damaged
+    void setHideFullHealthBars(bool hide) { hideFullHealthBars = hide; }
+    bool getHideFullHealthBars() const { return hideFullHealthBars; }
+
+    void drawEnemies(sf::RenderTarget& target) const { target.draw(enemyVertices); }
+    void drawHealthBars(sf::RenderTarget& target) const { target.draw(healthBarVertices); }
+    void drawBullets(sf::RenderTarget& target) const { target.draw(bulletVertices); }
+
+private:
+    void appendCircle(sf::VertexArray& vertices, sf::Vector2f center, float radius, sf::Color color) const;
+    void appendRect(sf::VertexArray& vertices, float left, float top, float width, float height, sf::Color color) const;
+    void setRect(sf::VertexArray& vertices, std::size_t first, float left, float top, float width, float height, sf::Color color) const;
+};
@@ -0,0 +1,564 @@
+#include "GameMap.h"
+#include "BinaryStream.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+// Cache file next to the map ("TDMC")
+const std::uint32_t MAP_CACHE_MAGIC = 0x434d4454;
+const std::uint16_t MAP_CACHE_VERSION = 2;
+
+// Most routes of a map (PathId is 16 bit)
+const std::size_t MAX_ROUTES = 65535;
+// Most waypoints of all routes together (Every branch copies the paths before it into each of its routes)
+const std::size_t MAX_ROUTE_WAYPOINTS = 1 << 22;
+
+// FNV-1a (Tells whether the map text changed since the cache was written)
+static std::uint64_t hashText(const std::string& text) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (char c : text) {
+        hash ^= std::uint8_t(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool GameMap::load(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        std::cerr << "Cannot open map " << filename << std::endl;
+        return false;
+    }
+    std::stringstream content;
+    content << file.rdbuf();
+    std::string text = content.str();
+    std::uint64_t hash = hashText(text);
+
+    // Use the cache if it was made from this text
+    std::string cacheFilename = filename + ".cache";
+    BinaryReader reader;
+    if (reader.loadFrom(cacheFilename) && reader.read<std::uint32_t>() == MAP_CACHE_MAGIC &&
+        reader.read<std::uint16_t>() == MAP_CACHE_VERSION && reader.read<std::uint64_t>() == hash) {
+        GameMap cached;
+        if (cached.readFrom(reader) && cached.readDerived(reader)) {
+            *this = std::move(cached);
+            return true;
+        }
+    }
+
+    GameMap parsed;
+    std::string error;
+    if (!parsed.parse(text, filename)) {
+        return false;
+    }
+    if (!parsed.finish(error)) {
+        std::cerr << filename << ": " << error << std::endl;
+        return false;
+    }
+    *this = std::move(parsed);
+
+    BinaryWriter writer;
+    writer.write<std::uint32_t>(MAP_CACHE_MAGIC);
+    writer.write<std::uint16_t>(MAP_CACHE_VERSION);
+    writer.write<std::uint64_t>(hash);
+    writeTo(writer);
+    writeDerived(writer);
+    writer.saveTo(cacheFilename); // Only makes the next start faster, nothing to do if it fails
+    return true;
+}
+
+bool GameMap::parse(const std::string& text, const std::string& filename) {
+    *this = GameMap();
+    std::istringstream lines(text);
+    std::string lineText;
+    int lineNumber = 0;
+
+    while (std::getline(lines, lineText)) {
+        lineNumber++;
+        if (!lineText.empty() && lineText.back() == '\r') {
+            lineText.pop_back();
+        }
+        std::istringstream line(lineText);
+        std::string key;
+        if (!(line >> key) || key[0] == '#') {
+            continue; // Empty line or comment
+        }
+
+        bool ok = true;
+        if (key == "name") {
+            std::getline(line >> std::ws, name);
+        }
+        else if (key == "size") {
+            ok = bool(line >> width >> height);
+        }
+        else if (key == "path") {
+            MapPath path;
+            ok = bool(line >> path.name);
+            float x, y;
+            while (ok && line >> x) {
+                ok = bool(line >> y);
+                path.waypoints.push_back(Vec2(x, y));
+            }
+            ok = ok && line.eof();
+            paths.push_back(path);
+        }
+        else if (key == "spawn") {
+            MapSpawn spawn{ std::string(), 1.0f };
+            ok = bool(line >> spawn.path);
+            if (ok && !(line >> std::ws).eof()) {
+                ok = bool(line >> spawn.weight) && (line >> std::ws).eof();
+            }
+            spawns.push_back(spawn);
+        }
+        else if (key == "next") {
+            MapLink link{ std::string(), std::string(), 1.0f };
+            ok = bool(line >> link.from >> link.to);
+            if (ok && !(line >> std::ws).eof()) {
+                ok = bool(line >> link.weight) && (line >> std::ws).eof();
+            }
+            links.push_back(link);
+        }
+        else if (key == "build") {
+            BuildZone zone;
+            ok = bool(line >> zone.x >> zone.y >> zone.width >> zone.height);
+            buildZones.push_back(zone);
+        }
+        else {
+            std::cerr << filename << ":" << lineNumber << ": unknown key " << key << std::endl;
+            return false;
+        }
+        if (!ok) {
+            std::cerr << filename << ":" << lineNumber << ": bad value for " << key << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GameMap::save(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file) {
+        std::cerr << "Cannot write map " << filename << std::endl;
+        return false;
+    }
+    file << "# Tower defense map (See GameMap.h)\n";
+    file << "name " << name << "\n";
+    file << "size " << width << " " << height << "\n";
+    for (const MapPath& path : paths) {
+        file << "path " << path.name;
+        for (const Vec2& waypoint : path.waypoints) {
+            file << " " << waypoint.x << " " << waypoint.y;
+        }
+        file << "\n";
+    }
+    for (const MapSpawn& spawn : spawns) {
+        file << "spawn " << spawn.path << " " << spawn.weight << "\n";
+    }
+    for (const MapLink& link : links) {
+        file << "next " << link.from << " " << link.to << " " << link.weight << "\n";
+    }
+    for (const BuildZone& zone : buildZones) {
+        file << "build " << zone.x << " " << zone.y << " " << zone.width << " " << zone.height << "\n";
+    }
+    return bool(file);
+}
+
+static bool insidePlayfield(const GameMap& map, Vec2 point) {
+    return point.x >= 0.0f && point.x <= map.width && point.y >= 0.0f && point.y <= map.height;
+}
+
+// Index of the path called name, paths.size() if there is none
+static std::size_t findPath(const std::vector<MapPath>& paths, const std::string& name) {
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        if (paths[i].name == name) {
+            return i;
+        }
+    }
+    return paths.size();
+}
+
+// Next paths of a path and the chance of going on to each of them
+typedef std::vector<std::pair<std::size_t, float>> NextPaths;
+
+// Walks every way from a spawn path to an exit (Depth first, one route per exit reached)
+struct RouteWalker {
+    const std::vector<MapPath>& paths;
+    const std::vector<NextPaths>& next;
+    std::vector<std::uint8_t> onRoute;  // Path is on the route being walked (Reaching it again is a loop)
+    std::vector<std::uint8_t> reached;  // Path is on at least one route
+    std::vector<std::size_t> route;     // Paths of the route being walked
+    std::vector<Vec2> waypoints;        // Their waypoints joined
+    std::size_t totalWaypoints = 0;
+    std::vector<Path> routes;
+    std::vector<std::string> routeNames;
+    std::vector<float> routeWeights;
+    std::string error;
+
+    RouteWalker(const std::vector<MapPath>& paths, const std::vector<NextPaths>& next)
+        : paths(paths), next(next), onRoute(paths.size(), 0), reached(paths.size(), 0) {
+    }
+
+    bool walk(std::size_t pathIndex, float chance) {
+        if (onRoute[pathIndex]) {
+            error = "paths loop through " + paths[pathIndex].name;
+            return false;
+        }
+        const std::vector<Vec2>& pathWaypoints = paths[pathIndex].waypoints;
+        std::size_t previousCount = waypoints.size();
+        // Merging paths usually start where the last one ended, do not walk that point twice
+        bool joined = !waypoints.empty() && waypoints.back().x == pathWaypoints.front().x && waypoints.back().y == pathWaypoints.front().y;
+        waypoints.insert(waypoints.end(), pathWaypoints.begin() + (joined ? 1 : 0), pathWaypoints.end());
+        onRoute[pathIndex] = 1;
+        reached[pathIndex] = 1;
+        route.push_back(pathIndex);
+
+        bool ok = true;
+        if (next[pathIndex].empty()) {
+            // Exit reached
+            totalWaypoints += waypoints.size();
+            if (routes.size() >= MAX_ROUTES || totalWaypoints > MAX_ROUTE_WAYPOINTS) {
+                error = "too many routes (Every branch multiplies the routes after it)";
+                ok = false;
+            }
+            else {
+                std::string name = paths[route[0]].name;
+                for (std::size_t i = 1; i < route.size(); ++i) {
+                    name += ">" + paths[route[i]].name;
+                }
+                routes.push_back(PathRegistry::makePath(waypoints));
+                routeNames.push_back(name);
+                routeWeights.push_back(chance);
+                if (routes.back().totalLength <= 0.0f) {
+                    error = "route " + name + " has length 0";
+                    ok = false;
+                }
+            }
+        }
+        for (std::size_t i = 0; ok && i < next[pathIndex].size(); ++i) {
+            ok = walk(next[pathIndex][i].first, chance * next[pathIndex][i].second);
+        }
+
+        onRoute[pathIndex] = 0;
+        route.pop_back();
+        waypoints.resize(previousCount);
+        return ok;
+    }
+};
+
+bool GameMap::buildRoutes(std::string& error) {
+    // Branches of every path, weights turned into chances
+    std::vector<NextPaths> next(paths.size());
+    std::vector<std::uint8_t> isNext(paths.size(), 0);
+    for (const MapLink& link : links) {
+        std::size_t from = findPath(paths, link.from);
+        std::size_t to = findPath(paths, link.to);
+        if (from == paths.size() || to == paths.size()) {
+            error = "next " + link.from + " " + link.to + ": no path called " + (from == paths.size() ? link.from : link.to);
+            return false;
+        }
+        if (!(link.weight > 0.0f && link.weight < 1e30f)) {
+            error = "next " + link.from + " " + link.to + ": weight must be above 0";
+            return false;
+        }
+        next[from].push_back(std::make_pair(to, link.weight));
+        isNext[to] = 1;
+    }
+    for (NextPaths& branches : next) {
+        float total = 0.0f;
+        for (const auto& branch : branches) {
+            total += branch.second;
+        }
+        for (auto& branch : branches) {
+            branch.second /= total;
+        }
+    }
+
+    // Spawn paths (Every path nothing leads to if the map has no spawn lines)
+    NextPaths entries;
+    for (const MapSpawn& spawn : spawns) {
+        std::size_t index = findPath(paths, spawn.path);
+        if (index == paths.size()) {
+            error = "spawn: no path called " + spawn.path;
+            return false;
+        }
+        if (!(spawn.weight > 0.0f && spawn.weight < 1e30f)) {
+            error = "spawn " + spawn.path + ": weight must be above 0";
+            return false;
+        }
+        entries.push_back(std::make_pair(index, spawn.weight));
+    }
+    if (spawns.empty()) {
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            if (!isNext[i]) {
+                entries.push_back(std::make_pair(i, 1.0f));
+            }
+        }
+    }
+    if (entries.empty()) {
+        error = "no spawn path (Every path is the next of another one)";
+        return false;
+    }
+    float totalWeight = 0.0f;
+    for (const auto& entry : entries) {
+        totalWeight += entry.second;
+    }
+
+    RouteWalker walker(paths, next);
+    for (const auto& entry : entries) {
+        if (!walker.walk(entry.first, entry.second / totalWeight)) {
+            error = walker.error;
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        if (!walker.reached[i]) {
+            error = "path " + paths[i].name + " cannot be reached from a spawn";
+            return false;
+        }
+    }
+    routes = std::move(walker.routes);
+    routeNames = std::move(walker.routeNames);
+    routeWeights = std::move(walker.routeWeights);
+    return true;
+}
+
+bool GameMap::finish(std::string& error) {
+    if (!(width > 0.0f && height > 0.0f && width <= 100000.0f && height <= 100000.0f)) {
+        error = "playfield size must be between 0 and 100000";
+        return false;
+    }
+    if (paths.empty()) {
+        error = "no path";
+        return false;
+    }
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        const MapPath& path = paths[i];
+        for (std::size_t j = 0; j < i; ++j) {
+            if (paths[j].name == path.name) {
+                error = "two paths are called " + path.name;
+                return false;
+            }
+        }
+        if (path.waypoints.size() < 2) {
+            error = "path " + path.name + " needs at least 2 waypoints";
+            return false;
+        }
+        for (const Vec2& waypoint : path.waypoints) {
+            if (!insidePlayfield(*this, waypoint)) {
+                error = "path " + path.name + " leaves the playfield";
+                return false;
+            }
+        }
+    }
+    for (const BuildZone& zone : buildZones) {
+        if (!(zone.width > 0.0f && zone.height > 0.0f) || !insidePlayfield(*this, Vec2(zone.x, zone.y)) ||
+            !insidePlayfield(*this, Vec2(zone.x + zone.width, zone.y + zone.height))) {
+            error = "build zone outside the playfield or of size 0";
+            return false;
+        }
+    }
+
+    // Every way from a spawn to an exit
+    routes.clear();
+    routeNames.clear();
+    routeWeights.clear();
+    if (!buildRoutes(error)) {
+        return false;
+    }
+
+    // A cell is buildable if its center is inside a zone
+    buildable.clear();
+    buildColumns = 0;
+    buildRows = 0;
+    if (!buildZones.empty()) {
+        buildColumns = int(std::ceil(width / BUILD_CELL_SIZE));
+        buildRows = int(std::ceil(height / BUILD_CELL_SIZE));
+        buildable.assign(std::size_t(buildColumns) * buildRows, 0);
+        for (const BuildZone& zone : buildZones) {
+            int firstColumn = int(zone.x / BUILD_CELL_SIZE);
+            int firstRow = int(zone.y / BUILD_CELL_SIZE);
+            for (int row = firstRow; row < buildRows && (row + 0.5f) * BUILD_CELL_SIZE <= zone.y + zone.height; ++row) {
+                for (int column = firstColumn; column < buildColumns && (column + 0.5f) * BUILD_CELL_SIZE <= zone.x + zone.width; ++column) {
+                    if ((row + 0.5f) * BUILD_CELL_SIZE >= zone.y && (column + 0.5f) * BUILD_CELL_SIZE >= zone.x) {
+                        buildable[std::size_t(row) * buildColumns + column] = 1;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool GameMap::canBuildAt(Vec2 position) const {
+    if (!insidePlayfield(*this, position)) {
+        return false; // Also NaN and infinity, which the enemy grid cannot hold
+    }
+    if (buildable.empty()) {
+        return true; // No zones: anywhere on the playfield
+    }
+    int column = std::min(int(position.x / BUILD_CELL_SIZE), buildColumns - 1);
+    int row = std::min(int(position.y / BUILD_CELL_SIZE), buildRows - 1);
+    return buildable[std::size_t(row) * buildColumns + column] != 0;
+}
+
+void GameMap::writeTo(BinaryWriter& writer) const {
+    writer.writeString(name);
+    writer.write<float>(width);
+    writer.write<float>(height);
+    writer.write<std::uint32_t>(std::uint32_t(paths.size()));
+    for (const MapPath& path : paths) {
+        writer.writeString(path.name);
+        writer.writeArray(path.waypoints, 8);
+    }
+    writer.write<std::uint32_t>(std::uint32_t(spawns.size()));
+    for (const MapSpawn& spawn : spawns) {
+        writer.writeString(spawn.path);
+        writer.write<float>(spawn.weight);
+    }
+    writer.write<std::uint32_t>(std::uint32_t(links.size()));
+    for (const MapLink& link : links) {
+        writer.writeString(link.from);
+        writer.writeString(link.to);
+        writer.write<float>(link.weight);
+    }
+    writer.writeArray(buildZones, 8);
+}
+
+bool GameMap::readFrom(BinaryReader& reader, bool withLanes) {
+    name = reader.readString();
+    width = reader.read<float>();
+    height = reader.read<float>();
+    std::uint32_t pathCount = reader.read<std::uint32_t>();
+    paths.clear();
+    for (std::uint32_t i = 0; i < pathCount && reader.isOk(); ++i) {
+        MapPath path;
+        path.name = reader.readString();
+        reader.readArray(path.waypoints, 8);
+        paths.push_back(path);
+    }
+    spawns.clear();
+    links.clear();
+    if (withLanes) {
+        std::uint32_t spawnCount = reader.read<std::uint32_t>();
+        for (std::uint32_t i = 0; i < spawnCount && reader.isOk(); ++i) {
+            MapSpawn spawn;
+            spawn.path = reader.readString();
+            spawn.weight = reader.read<float>();
+            spawns.push_back(spawn);
+        }
+        std::uint32_t linkCount = reader.read<std::uint32_t>();
+        for (std::uint32_t i = 0; i < linkCount && reader.isOk(); ++i) {
+            MapLink link;
+            link.from = reader.readString();
+            link.to = reader.readString();
+            link.weight = reader.read<float>();
+            links.push_back(link);
+        }
+    }
+    reader.readArray(buildZones, 8);
+    routes.clear();
+    routeNames.clear();
+    routeWeights.clear();
+    buildable.clear();
+    return reader.isOk();
+}
+
+void GameMap::writeDerived(BinaryWriter& writer) const {
+    writer.write<std::uint32_t>(std::uint32_t(routes.size()));
+    for (std::size_t i = 0; i < routes.size(); ++i) {
+        const Path& route = routes[i];
+        writer.writeString(routeNames[i]);
+        writer.writeArray(route.waypoints, 8);
+        writer.writeArray(route.direction, 8);
+        writer.writeArray(route.segmentLength, 8);
+        writer.writeArray(route.cumulativeLength, 8);
+        writer.write<float>(route.totalLength);
+    }
+    writer.writeArray(routeWeights, 8);
+    writer.write<std::int32_t>(buildColumns);
+    writer.write<std::int32_t>(buildRows);
+    writer.writeArray(buildable, 8);
+}
+
+bool GameMap::readDerived(BinaryReader& reader) {
+    std::uint32_t routeCount = reader.read<std::uint32_t>();
+    routes.clear();
+    routeNames.clear();
+    for (std::uint32_t i = 0; i < routeCount && reader.isOk(); ++i) {
+        Path route;
+        routeNames.push_back(reader.readString());
+        reader.readArray(route.waypoints, 8);
+        reader.readArray(route.direction, 8);
+        reader.readArray(route.segmentLength, 8);
+        reader.readArray(route.cumulativeLength, 8);
+        route.totalLength = reader.read<float>();
+        if (route.waypoints.size() < 2 || route.direction.size() + 1 != route.waypoints.size() ||
+            route.segmentLength.size() != route.direction.size() || route.cumulativeLength.size() != route.waypoints.size()) {
+            return false;
+        }
+        routes.push_back(route);
+    }
+    reader.readArray(routeWeights, 8);
+    buildColumns = reader.read<std::int32_t>();
+    buildRows = reader.read<std::int32_t>();
+    reader.readArray(buildable, 8);
+    return reader.isOk() && !routes.empty() && routeWeights.size() == routes.size() &&
+        buildable.size() == std::size_t(buildColumns) * std::size_t(buildRows);
+}
+
+bool GameMap::sameLayout(const GameMap& other) const {
+    if (width != other.width || height != other.height || paths.size() != other.paths.size() || buildZones.size() != other.buildZones.size() ||
+        spawns.size() != other.spawns.size() || links.size() != other.links.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < spawns.size(); ++i) {
+        if (spawns[i].path != other.spawns[i].path || spawns[i].weight != other.spawns[i].weight) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < links.size(); ++i) {
+        const MapLink& a = links[i];
+        const MapLink& b = other.links[i];
+        if (a.from != b.from || a.to != b.to || a.weight != b.weight) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        const std::vector<Vec2>& a = paths[i].waypoints;
+        const std::vector<Vec2>& b = other.paths[i].waypoints;
+        if (paths[i].name != other.paths[i].name || a.size() != b.size()) {
+            return false;
+        }
+        for (std::size_t w = 0; w < a.size(); ++w) {
+            if (a[w].x != b[w].x || a[w].y != b[w].y) {
+                return false;
+            }
+        }
+    }
+    for (std::size_t i = 0; i < buildZones.size(); ++i) {
+        const BuildZone& a = buildZones[i];
+        const BuildZone& b = other.buildZones[i];
+        if (a.x != b.x || a.y != b.y || a.width != b.width || a.height != b.height) {
+            return false;
+        }
+    }
+    return true;
+}
+
+GameMap GameMap::fromPath(const std::vector<Vec2>& waypoints, const std::string& name) {
+    GameMap map;
+    map.name = name;
+    MapPath path;
+    path.name = "main";
+    path.waypoints = waypoints;
+    map.paths.push_back(path);
+    std::string error;
+    if (!map.finish(error)) {
+        std::cerr << name << ": " << error << std::endl;
+    }
+    return map;
+}
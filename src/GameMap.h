@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Vec2.h"
+#include "PathRegistry.h"
+
+class BinaryWriter;
+class BinaryReader;
+
+// Playfield size of the built-in levels (Bullets leaving the playfield are removed)
+const float PLAYFIELD_WIDTH = 800.0f;
+const float PLAYFIELD_HEIGHT = 600.0f;
+
+// Side of the cells of the buildable grid (Towers are placed on a cell whose center is in a zone)
+const float BUILD_CELL_SIZE = 10.0f;
+
+// Map file (Text, so designers can write maps without rebuilding the game)
+/*
+*   # Comment
+*   name Level 1
+*   size 800 600                    Playfield width and height
+*   path main 0 100 200 100 ...     Piece of path enemies walk along: name, then x y of every waypoint
+*   spawn main 2                    Enemies enter on path main, weight 2 (Optional weight, default 1)
+*   next main left 3                At the end of main, enemies go on to left with weight 3 (Optional weight, default 1)
+*   build 0 0 800 90                Rectangle where towers can be built: x y width height
+* Every waypoint and zone must be inside the playfield. Without build lines towers can be
+* built anywhere on the playfield.
+*
+* Lanes and branches: a path with several next lines branches (Enemies pick one by weight),
+* several next lines to the same path merge, a path without next lines ends at the exit.
+* Without spawn lines enemies enter on every path no next line leads to, with the same chance.
+* Paths must not loop. If a next path does not start where the last one ended, enemies walk
+* straight to its start.
+*
+* Loading checks the map, then works out every route (Spawn path, then next paths up to an
+* exit, joined into one Path), its chance and the buildable grid. Enemies only keep the id of
+* their route and how far they walked, like on a map with one path. That is saved next to the
+* map ("file.map.cache", binary) and used as long as the map text does not change, so
+* hundreds of maps load without being parsed again.
+*
+* How to use:
+* GameMap map;
+* if (map.load("Game File/Map Level 1.map")) {
+*     Simulation simulation(map, seed);
+* }
+*/
+struct MapPath {
+    std::string name;
+    std::vector<Vec2> waypoints;
+};
+
+struct MapSpawn {
+    std::string path;
+    float weight;
+};
+
+struct MapLink {
+    std::string from;
+    std::string to;
+    float weight;
+};
+
+struct BuildZone {
+    float x, y, width, height;
+};
+
+struct GameMap {
+    std::string name;
+    float width = PLAYFIELD_WIDTH;
+    float height = PLAYFIELD_HEIGHT;
+    std::vector<MapPath> paths;
+    std::vector<MapSpawn> spawns;
+    std::vector<MapLink> links;
+    std::vector<BuildZone> buildZones;
+
+    // Worked out by finish() (Stored in the cache file)
+    std::vector<Path> routes;              // Walk of every route an enemy can take (PathId = index)
+    std::vector<std::string> routeNames;   // Names of its paths joined by '>' (E.g. "main>left")
+    std::vector<float> routeWeights;       // Chance of a new enemy taking every route (Sums to 1)
+    std::vector<std::uint8_t> buildable;   // One per cell, row by row (Empty = build anywhere)
+    int buildColumns = 0;
+    int buildRows = 0;
+
+    // Read the map, or its cache if the map did not change (Errors go to std::cerr)
+    bool load(const std::string& filename);
+    bool parse(const std::string& text, const std::string& filename);
+    bool save(const std::string& filename) const;
+
+    // Check the map and work out routes and buildable grid, error describes the first problem
+    bool finish(std::string& error);
+
+    // What the map file says (No derived data, call finish() after readFrom)
+    // withLanes: false for data written before maps had spawn and next lines
+    void writeTo(BinaryWriter& writer) const;
+    bool readFrom(BinaryReader& reader, bool withLanes = true);
+
+    // Same playfield, paths, lanes and zones
+    bool sameLayout(const GameMap& other) const;
+
+    // Can a tower be placed with its center at position
+    bool canBuildAt(Vec2 position) const;
+
+    // Map with one path on the built-in playfield (Old replays, tools)
+    static GameMap fromPath(const std::vector<Vec2>& waypoints, const std::string& name);
+
+private:
+    bool buildRoutes(std::string& error);
+    void writeDerived(BinaryWriter& writer) const;
+    bool readDerived(BinaryReader& reader);
+};
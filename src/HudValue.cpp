@@ -0,0 +1,30 @@
+#include "HudValue.h"
+
+#include <cstdio>
+
+HudValue::HudValue() : value(0), dirty(true) {}
+
+void HudValue::setLabel(const std::string& newLabel) {
+    if (newLabel != label) {
+        label = newLabel;
+        dirty = true;
+    }
+}
+
+void HudValue::setValue(int newValue) {
+    if (newValue == value && !dirty) {
+        return;
+    }
+    value = newValue;
+    dirty = false;
+
+    char digits[16];
+    std::snprintf(digits, sizeof(digits), "%d", value);
+    buffer = label;
+    buffer += digits;
+    text.setString(buffer);
+}
+
+void HudValue::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    target.draw(text, states);
+}
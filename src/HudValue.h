@@ -0,0 +1,41 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <string>
+
+// HUD text showing a label and a number ("Life: 100")
+/*
+* The text is only rebuilt when the number changes, so setting the same value every frame
+* costs one comparison (No std::to_string, no sf::String conversion, no glyph layout).
+*
+* How to use:
+* HudValue lifeText;
+* lifeText.setFont(font); lifeText.setLabel("Life: "); ...  // Same setters as sf::Text
+* lifeText.setValue(life);                                   // Every frame
+* window.draw(lifeText);
+*/
+class HudValue : public sf::Drawable {
+private:
+    sf::Text text;
+    std::string label;
+    std::string buffer; // Kept to reuse its memory
+    int value;
+    bool dirty;         // Label changed, rebuild even if the value did not
+
+public:
+    HudValue();
+
+    void setFont(const sf::Font& font) { text.setFont(font); }
+    void setCharacterSize(unsigned int size) { text.setCharacterSize(size); }
+    void setFillColor(const sf::Color& color) { text.setFillColor(color); }
+    void setPosition(float x, float y) { text.setPosition(x, y); }
+    void setLabel(const std::string& newLabel);
+
+    // Rebuild the text only if value is not the one shown
+    void setValue(int newValue);
+    int getValue() const { return value; }
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+};
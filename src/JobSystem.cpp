@@ -0,0 +1,190 @@
+#include "JobSystem.h"
+#include "Trace.h"
+
+#include <cassert>
+
+// Queue of the current thread (Workers set their own, other threads use queue 0)
+static thread_local int threadQueue = 0;
+
+bool JobQueue::push(const Job& job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (newest - oldest == JOB_QUEUE_SIZE) {
+        return false;
+    }
+    jobs[newest % JOB_QUEUE_SIZE] = job;
+    newest++;
+    return true;
+}
+
+bool JobQueue::pop(Job& job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (newest == oldest) {
+        return false;
+    }
+    newest--;
+    job = jobs[newest % JOB_QUEUE_SIZE];
+    return true;
+}
+
+bool JobQueue::steal(Job& job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (newest == oldest) {
+        return false;
+    }
+    job = jobs[oldest % JOB_QUEUE_SIZE];
+    oldest++;
+    return true;
+}
+
+JobSystem& JobSystem::get() {
+    static JobSystem jobSystem;
+    return jobSystem;
+}
+
+JobSystem::JobSystem() : queuedJobs(0), stopping(false) {
+    int cores = int(std::thread::hardware_concurrency());
+    setThreadCount(cores > 1 ? cores - 1 : 0);
+}
+
+JobSystem::~JobSystem() {
+    stopThreads();
+}
+
+void JobSystem::setThreadCount(int count) {
+    stopThreads();
+    stopping = false;
+    queues.clear();
+    for (int i = 0; i <= count; ++i) {
+        queues.push_back(std::unique_ptr<JobQueue>(new JobQueue()));
+    }
+    for (int i = 0; i < count; ++i) {
+        threads.emplace_back(&JobSystem::workerLoop, this, i + 1);
+    }
+}
+
+void JobSystem::stopThreads() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+}
+
+void JobSystem::submit(JobFunction function, const void* context, std::size_t begin, std::size_t end, std::atomic<int>& pending) {
+    Job job;
+    job.function = function;
+    job.context = context;
+    job.begin = begin;
+    job.end = end;
+    job.pending = &pending;
+    pending.fetch_add(1, std::memory_order_relaxed);
+
+    if (!queues[threadQueue]->push(job)) {
+        // Queue full, do it now
+        function(context, begin, end);
+        pending.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+    queuedJobs.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex); // A worker cannot be between its check and its sleep
+    }
+    wake.notify_one();
+}
+
+void JobSystem::wait(std::atomic<int>& pending) {
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (!runOneJob()) {
+            std::this_thread::yield(); // The last jobs are running on other threads
+        }
+    }
+}
+
+bool JobSystem::runOneJob() {
+    Job job;
+    bool found = queues[threadQueue]->pop(job);
+    // Steal from the other queues, starting with the next one
+    for (std::size_t i = 1; !found && i < queues.size(); ++i) {
+        found = queues[(threadQueue + i) % queues.size()]->steal(job);
+    }
+    if (!found) {
+        return false;
+    }
+    queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    job.function(job.context, job.begin, job.end);
+    job.pending->fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void JobSystem::workerLoop(int queueIndex) {
+    threadQueue = queueIndex;
+    while (true) {
+        if (runOneJob()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || queuedJobs.load(std::memory_order_acquire) > 0; });
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+int TaskGraph::addTask(const char* name, TaskFunction function, const void* context) {
+    assert(taskCount < MAX_GRAPH_TASKS);
+    Task& task = tasks[taskCount];
+    task.name = name;
+    task.function = function;
+    task.context = context;
+    task.dependencyCount = 0;
+    task.dependentCount = 0;
+    return taskCount++;
+}
+
+void TaskGraph::dependsOn(int task, int before) {
+    assert(before < task && tasks[before].dependentCount < MAX_TASK_DEPENDENTS);
+    tasks[before].dependents[tasks[before].dependentCount++] = task;
+    tasks[task].dependencyCount++;
+}
+
+void TaskGraph::runTask(const void* graph, std::size_t taskIndex, std::size_t) {
+    TaskGraph& self = *const_cast<TaskGraph*>(static_cast<const TaskGraph*>(graph));
+    Task& task = self.tasks[taskIndex];
+    {
+        TraceScope trace(task.name);
+        task.function(task.context);
+    }
+
+    // Start the tasks that were only waiting for this one
+    for (int i = 0; i < task.dependentCount; ++i) {
+        Task& dependent = self.tasks[task.dependents[i]];
+        if (dependent.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            JobSystem::get().submit(&TaskGraph::runTask, graph, std::size_t(task.dependents[i]), 0, self.pending);
+        }
+    }
+}
+
+void TaskGraph::run() {
+    JobSystem& jobSystem = JobSystem::get();
+    if (jobSystem.getThreadCount() == 0) {
+        for (int i = 0; i < taskCount; ++i) {
+            TraceScope trace(tasks[i].name);
+            tasks[i].function(tasks[i].context);
+        }
+        return;
+    }
+
+    for (int i = 0; i < taskCount; ++i) {
+        tasks[i].remaining.store(tasks[i].dependencyCount, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < taskCount; ++i) {
+        if (tasks[i].dependencyCount == 0) {
+            jobSystem.submit(&TaskGraph::runTask, this, std::size_t(i), 0, pending);
+        }
+    }
+    jobSystem.wait(pending);
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Jobs one queue can hold (A thread runs the job itself when its queue is full)
+const std::size_t JOB_QUEUE_SIZE = 1024;
+
+// Size limits of a TaskGraph (Fixed, so building a graph every tick does not allocate)
+const int MAX_GRAPH_TASKS = 16;
+const int MAX_TASK_DEPENDENTS = 8;
+
+typedef void (*JobFunction)(const void* context, std::size_t begin, std::size_t end);
+
+// Call function(context, begin, end), then decrement pending
+struct Job {
+    JobFunction function = nullptr;
+    const void* context = nullptr;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    std::atomic<int>* pending = nullptr;
+};
+
+// Jobs of one thread (The owner takes the newest job, other threads steal the oldest)
+class JobQueue {
+private:
+    std::mutex mutex;
+    Job jobs[JOB_QUEUE_SIZE];
+    std::size_t oldest = 0;  // jobs[oldest % JOB_QUEUE_SIZE] ... jobs[(newest - 1) % JOB_QUEUE_SIZE]
+    std::size_t newest = 0;
+
+public:
+    bool push(const Job& job);  // false if the queue is full
+    bool pop(Job& job);
+    bool steal(Job& job);
+};
+
+// Work stealing job system
+/*
+* Every worker thread has its own queue of jobs. A thread with nothing left in its queue
+* steals the oldest job of another queue, so a thread that submitted many jobs gets help
+* without a shared queue everybody fights over. A thread waiting for its jobs runs jobs too.
+* Threads outside the pool (E.g. the main thread) share queue 0.
+*
+* With 0 worker threads parallelFor() and TaskGraph::run() call everything on the calling
+* thread in order.
+*
+* How to use:
+* JobSystem::get().parallelFor(towers.size(), 32, [&](std::size_t begin, std::size_t end) {
+*     for (std::size_t i = begin; i < end; ++i) {...}   // Only write data of your own indices
+* });
+*/
+class JobSystem {
+public:
+    static JobSystem& get();
+
+    // Number of threads besides the calling thread (Default: one less than the number of cores)
+    // Only change it while no job is running
+    void setThreadCount(int count);
+    int getThreadCount() const { return int(threads.size()); }
+
+    // Queue a job on the queue of this thread
+    void submit(JobFunction function, const void* context, std::size_t begin, std::size_t end, std::atomic<int>& pending);
+
+    // Run jobs until pending is 0
+    void wait(std::atomic<int>& pending);
+
+    // Call function(begin, end) on chunks of at most chunkSize indices of [0, count), return when all are done
+    template <typename Function>
+    void parallelFor(std::size_t count, std::size_t chunkSize, const Function& function) {
+        if (threads.empty() || count <= chunkSize) {
+            function(std::size_t(0), count);
+            return;
+        }
+        std::atomic<int> pending(0);
+        for (std::size_t begin = 0; begin < count; begin += chunkSize) {
+            std::size_t end = (begin + chunkSize < count) ? begin + chunkSize : count;
+            submit(&callChunk<Function>, &function, begin, end, pending);
+        }
+        wait(pending);
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+private:
+    // Plain function pointer instead of std::function, so a loop does not allocate
+    template <typename Function>
+    static void callChunk(const void* context, std::size_t begin, std::size_t end) {
+        (*static_cast<const Function*>(context))(begin, end);
+    }
+
+    JobSystem();
+    ~JobSystem();
+
+    bool runOneJob();
+    void workerLoop(int queueIndex);
+    void stopThreads();
+
+    std::vector<std::unique_ptr<JobQueue>> queues; // [0] = threads outside the pool, [i + 1] = worker i
+    std::vector<std::thread> threads;
+    std::mutex sleepMutex;
+    std::condition_variable wake;   // A job was queued (Or the pool is stopping)
+    std::atomic<int> queuedJobs;
+    bool stopping;
+};
+
+typedef void (*TaskFunction)(const void* context);
+
+// Stages of work with dependencies between them, run on the JobSystem
+/*
+* A task starts when every task it depends on is done, tasks without a path between them
+* may run at the same time on different threads (And may use parallelFor inside).
+* With 0 worker threads the tasks run one after another in the order they were added.
+*
+* How to use:
+* auto move = [&] {...};                 // Must live until run() returns
+* auto collide = [&] {...};
+* TaskGraph graph;
+* int moveTask = graph.add("Move", move);
+* int collideTask = graph.add("Collide", collide);
+* graph.dependsOn(collideTask, moveTask);
+* graph.run();
+*/
+class TaskGraph {
+private:
+    struct Task {
+        const char* name;
+        TaskFunction function;
+        const void* context;
+        int dependencyCount;
+        std::atomic<int> remaining;   // Dependencies not done yet in the current run
+        int dependents[MAX_TASK_DEPENDENTS];
+        int dependentCount;
+    };
+
+    Task tasks[MAX_GRAPH_TASKS];
+    int taskCount;
+    std::atomic<int> pending;
+
+    template <typename Function>
+    static void callTask(const void* context) {
+        (*static_cast<const Function*>(context))();
+    }
+
+    static void runTask(const void* graph, std::size_t task, std::size_t);
+
+public:
+    TaskGraph() : taskCount(0), pending(0) {}
+
+    // Add a task, return its id (name is shown in traces)
+    template <typename Function>
+    int add(const char* name, const Function& function) {
+        return addTask(name, &callTask<Function>, &function);
+    }
+    int addTask(const char* name, TaskFunction function, const void* context);
+
+    // task starts after before is done (Add before first, so the add order is a valid order)
+    void dependsOn(int task, int before);
+
+    void run();
+
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+};
@@ -0,0 +1,30 @@
+#include "PathRegistry.h"
+
+#include <cmath>
+#include <utility>
+
+Path PathRegistry::makePath(const std::vector<Vec2>& waypoints) {
+    Path path;
+    path.waypoints = waypoints;
+
+    float distance = 0.0f;
+    for (std::size_t i = 0; i < waypoints.size(); ++i) {
+        path.cumulativeLength.push_back(distance);
+        if (i + 1 < waypoints.size()) {
+            Vec2 offset = waypoints[i + 1] - waypoints[i];
+            float length = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+            path.segmentLength.push_back(length);
+            // Two waypoints at the same place give a segment of length 0 that nobody walks on
+            path.direction.push_back(length > 0.0f ? offset / length : Vec2());
+            distance += length;
+        }
+    }
+    path.totalLength = distance;
+    return path;
+}
+
+PathId PathRegistry::add(const Path& path) {
+    paths.push_back(std::unique_ptr<const Path>(new Path(path)));
+    lengths.push_back(path.totalLength);
+    return PathId(paths.size() - 1);
+}
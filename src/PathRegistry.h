@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+#include "Vec2.h"
+
+typedef std::uint16_t PathId;
+
+// Path enemies walk along (Never changed after it is added to the registry)
+/*
+* Everything about the path is worked out once when it is added, so an enemy only needs
+* to remember how far it has walked (distance) to know where it is.
+*/
+struct Path {
+    std::vector<Vec2> waypoints;
+    std::vector<Vec2> direction;          // Unit direction of segment i (waypoints[i] -> waypoints[i + 1])
+    std::vector<float> segmentLength;     // Length of segment i
+    std::vector<float> cumulativeLength;  // Distance from the start to waypoints[i]
+    float totalLength = 0.0f;
+
+    // Position after walking distance along the path
+    // segment is the segment the enemy was on last time, it only moves forward
+    Vec2 positionAt(float distance, std::uint32_t& segment) const {
+        if (distance >= totalLength) {
+            segment = std::uint32_t(segmentLength.size());
+            return waypoints.back();
+        }
+        while (segment + 1 < segmentLength.size() && distance >= cumulativeLength[segment + 1]) {
+            segment++;
+        }
+        return waypoints[segment] + direction[segment] * (distance - cumulativeLength[segment]);
+    }
+};
+
+// All the paths of a match
+class PathRegistry {
+private:
+    std::vector<std::unique_ptr<const Path>> paths; // unique_ptr so references stay valid when more paths are added
+    std::vector<float> lengths;                     // totalLength of every path, side by side (Read for every enemy every tick)
+
+public:
+    // Precompute a path from its waypoints and return its id
+    PathId add(const std::vector<Vec2>& waypoints) { return add(makePath(waypoints)); }
+    // Add a path that was precomputed already (E.g. read from a map cache)
+    PathId add(const Path& path);
+
+    // Everything about the path worked out from its waypoints
+    static Path makePath(const std::vector<Vec2>& waypoints);
+
+    const Path& get(PathId id) const { return *paths[id]; }
+    float length(PathId id) const { return lengths[id]; }
+    std::size_t size() const { return paths.size(); }
+};
@@ -0,0 +1,62 @@
+#include "Profiler.h"
+
+Profiler& Profiler::get() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler() : enabled(false), historyIndex(0), historyCount(0) {
+    for (int zone = 0; zone < int(ProfileZone::Count); ++zone) {
+        current[zone].store(0);
+        historySum[zone] = 0;
+        for (int frame = 0; frame < PROFILE_HISTORY; ++frame) {
+            history[zone][frame] = 0;
+        }
+    }
+}
+
+void Profiler::endFrame() {
+    if (!isEnabled()) {
+        return;
+    }
+    for (int zone = 0; zone < int(ProfileZone::Count); ++zone) {
+        // Replace the oldest frame in the rolling sum
+        std::int64_t time = current[zone].exchange(0, std::memory_order_relaxed);
+        historySum[zone] += time - history[zone][historyIndex];
+        history[zone][historyIndex] = time;
+    }
+    historyIndex = (historyIndex + 1) % PROFILE_HISTORY;
+    if (historyCount < PROFILE_HISTORY) {
+        historyCount++;
+    }
+}
+
+float Profiler::averageMilliseconds(ProfileZone zone) const {
+    if (historyCount == 0) {
+        return 0.0f;
+    }
+    return historySum[int(zone)] / 1000000.0f / historyCount;
+}
+
+float Profiler::historyMilliseconds(ProfileZone zone, int framesAgo) const {
+    if (framesAgo >= historyCount) {
+        return 0.0f;
+    }
+    int index = (historyIndex - 1 - framesAgo + PROFILE_HISTORY) % PROFILE_HISTORY;
+    return history[int(zone)][index] / 1000000.0f;
+}
+
+const char* Profiler::zoneName(ProfileZone zone) {
+    switch (zone) {
+    case ProfileZone::Frame: return "Frame";
+    case ProfileZone::HandleEvents: return "Events";
+    case ProfileZone::Update: return "Update";
+    case ProfileZone::Render: return "Render";
+    case ProfileZone::TowerTargeting: return "  Tower targeting";
+    case ProfileZone::BulletCollision: return "  Bullet collision";
+    case ProfileZone::EnemyMovement: return "  Enemy movement";
+    case ProfileZone::Audio: return "  Audio";
+    case ProfileZone::DrawSubmission: return "  Draw submission";
+    default: return "";
+    }
+}
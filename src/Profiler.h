@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Parts of a frame that are timed
+enum class ProfileZone {
+    Frame,
+    HandleEvents,
+    Update,
+    Render,
+    TowerTargeting,   // Inside Update
+    BulletCollision,  // Inside Update
+    EnemyMovement,    // Inside Update
+    Audio,            // Inside Update
+    DrawSubmission,   // Inside Render
+    Count
+};
+
+// Frames kept for the rolling averages and the frame time graph
+const int PROFILE_HISTORY = 120;
+
+// Frame profiler (Collect the time spent in every zone, frame by frame)
+/*
+* How to use:
+* { ScopedTimer timer(ProfileZone::Update); ... }   // Time a block
+* Profiler::get().endFrame();                       // Once per frame, after everything
+* Profiler::get().averageMilliseconds(ProfileZone::Update);
+*
+* When disabled a ScopedTimer only checks one flag.
+* ScopedTimer and add() may run on any thread (The simulation thread, job workers). endFrame(),
+* setEnabled() and the history functions belong to the thread that draws the overlay.
+*/
+class Profiler {
+public:
+    static Profiler& get();
+
+    void setEnabled(bool enable) { enabled.store(enable, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // Add time to a zone of the current frame (Any thread, zones timed on several threads add up)
+    void add(ProfileZone zone, std::int64_t nanoseconds) { current[int(zone)].fetch_add(nanoseconds, std::memory_order_relaxed); }
+
+    // Close the current frame and start a new one
+    void endFrame();
+
+    // Average time of a zone over the last PROFILE_HISTORY frames
+    float averageMilliseconds(ProfileZone zone) const;
+
+    // Time of a zone "framesAgo" frames ago (0 = last finished frame)
+    float historyMilliseconds(ProfileZone zone, int framesAgo) const;
+
+    static const char* zoneName(ProfileZone zone);
+
+private:
+    Profiler();
+
+    std::atomic<bool> enabled;         // Read by every thread that times a zone
+    std::atomic<std::int64_t> current[int(ProfileZone::Count)];
+    std::int64_t history[int(ProfileZone::Count)][PROFILE_HISTORY]; // Only touched by the drawing thread
+    std::int64_t historySum[int(ProfileZone::Count)];
+    int historyIndex;  // Slot the next finished frame goes to
+    int historyCount;  // Finished frames stored (Up to PROFILE_HISTORY)
+};
+
+// Time from construction to destruction is added to the zone
+class ScopedTimer {
+private:
+    ProfileZone zone;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit ScopedTimer(ProfileZone zone) : zone(zone), active(Profiler::get().isEnabled()) {
+        if (active) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedTimer() {
+        if (active) {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            Profiler::get().add(zone, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
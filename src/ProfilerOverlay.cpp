@@ -0,0 +1,83 @@
+#include "ProfilerOverlay.h"
+
+#include <cstdio>
+#include <string>
+
+// Size of the frame time graph
+const float GRAPH_WIDTH = 240.0f;
+const float GRAPH_HEIGHT = 60.0f;
+const float GRAPH_MAX_MILLISECONDS = 33.3f; // Frame time at the top of the graph (30 FPS)
+
+ProfilerOverlay::ProfilerOverlay(const sf::Font& font, sf::Vector2f position)
+    : graph(sf::Triangles), targetLine(sf::Lines, 2), position(position), visible(false), framesUntilText(0) {
+    background.setSize(sf::Vector2f(GRAPH_WIDTH + 10.0f, 230.0f));
+    background.setFillColor(sf::Color(0, 0, 0, 180));
+    background.setPosition(position);
+
+    text.setFont(font);
+    text.setCharacterSize(12);
+    text.setFillColor(sf::Color::White);
+    text.setPosition(position.x + 5.0f, position.y + 5.0f);
+
+    // 16.7 ms line
+    float lineY = position.y + 225.0f - GRAPH_HEIGHT * (16.7f / GRAPH_MAX_MILLISECONDS);
+    targetLine[0] = sf::Vertex(sf::Vector2f(position.x + 5.0f, lineY), sf::Color::Yellow);
+    targetLine[1] = sf::Vertex(sf::Vector2f(position.x + 5.0f + GRAPH_WIDTH, lineY), sf::Color::Yellow);
+}
+
+void ProfilerOverlay::toggle() {
+    visible = !visible;
+    Profiler::get().setEnabled(visible);
+    framesUntilText = 0;
+}
+
+void ProfilerOverlay::update() {
+    if (!visible) {
+        return;
+    }
+    const Profiler& profiler = Profiler::get();
+
+    // Averages (Text layout is slow, so only every 15 frames)
+    if (--framesUntilText <= 0) {
+        framesUntilText = 15;
+        std::string lines;
+        char line[64];
+        float frame = profiler.averageMilliseconds(ProfileZone::Frame);
+        std::snprintf(line, sizeof(line), "FPS %.0f\n", frame > 0.0f ? 1000.0f / frame : 0.0f);
+        lines += line;
+        for (int zone = 0; zone < int(ProfileZone::Count); ++zone) {
+            std::snprintf(line, sizeof(line), "%-20s %6.3f ms\n", Profiler::zoneName(ProfileZone(zone)), profiler.averageMilliseconds(ProfileZone(zone)));
+            lines += line;
+        }
+        text.setString(lines);
+    }
+
+    // Frame time graph (Newest frame on the right)
+    graph.clear();
+    float barWidth = GRAPH_WIDTH / PROFILE_HISTORY;
+    float bottom = position.y + 225.0f;
+    for (int i = 0; i < PROFILE_HISTORY; ++i) {
+        float milliseconds = profiler.historyMilliseconds(ProfileZone::Frame, PROFILE_HISTORY - 1 - i);
+        float height = GRAPH_HEIGHT * ((milliseconds > GRAPH_MAX_MILLISECONDS) ? 1.0f : milliseconds / GRAPH_MAX_MILLISECONDS);
+        sf::Color color = (milliseconds > 16.7f) ? sf::Color::Red : sf::Color::Green;
+        float left = position.x + 5.0f + i * barWidth;
+        sf::Vector2f topLeft(left, bottom - height), topRight(left + barWidth, bottom - height);
+        sf::Vector2f bottomLeft(left, bottom), bottomRight(left + barWidth, bottom);
+        graph.append(sf::Vertex(topLeft, color));
+        graph.append(sf::Vertex(topRight, color));
+        graph.append(sf::Vertex(bottomRight, color));
+        graph.append(sf::Vertex(topLeft, color));
+        graph.append(sf::Vertex(bottomRight, color));
+        graph.append(sf::Vertex(bottomLeft, color));
+    }
+}
+
+void ProfilerOverlay::draw(sf::RenderTarget& target) const {
+    if (!visible) {
+        return;
+    }
+    target.draw(background);
+    target.draw(text);
+    target.draw(graph);
+    target.draw(targetLine);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include "Profiler.h"
+
+// In-game profiler overlay (Rolling average of every zone and a frame time graph)
+/*
+* How to use:
+* overlay.toggle();        // Show / hide (Also turns the Profiler on / off)
+* overlay.update();        // Once per frame
+* overlay.draw(window);
+*/
+class ProfilerOverlay {
+private:
+    sf::RectangleShape background;
+    sf::Text text;
+    sf::VertexArray graph;      // One bar per frame of the history
+    sf::VertexArray targetLine; // Frame time of 60 FPS
+    sf::Vector2f position;
+    bool visible;
+    int framesUntilText;        // The text is rebuilt a few times per second only
+
+public:
+    ProfilerOverlay(const sf::Font& font, sf::Vector2f position);
+
+    void toggle();
+    bool isVisible() const { return visible; }
+
+    void update();
+    void draw(sf::RenderTarget& target) const;
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+
+// Small fast random generator (PCG32: 16 bytes of state, a few instructions per number)
+/*
+* Same seed and stream always give the same numbers on every machine, so a match can be
+* replayed exactly. Different streams with the same seed are independent sequences.
+*/
+class Pcg32 {
+private:
+    std::uint64_t state;
+    std::uint64_t increment; // Selects the stream, must be odd
+
+public:
+    explicit Pcg32(std::uint64_t seed = 0x853c49e6748fea9bULL, std::uint64_t stream = 0xda3e39cb94b95bdbULL) {
+        reseed(seed, stream);
+    }
+
+    void reseed(std::uint64_t seed, std::uint64_t stream) {
+        state = 0;
+        increment = (stream << 1u) | 1u;
+        next();
+        state += seed;
+        next();
+    }
+
+    // Uniform 32 bit number
+    std::uint32_t next() {
+        std::uint64_t oldState = state;
+        state = oldState * 6364136223846793005ULL + increment;
+        std::uint32_t xorShifted = std::uint32_t(((oldState >> 18u) ^ oldState) >> 27u);
+        std::uint32_t rotation = std::uint32_t(oldState >> 59u);
+        return (xorShifted >> rotation) | (xorShifted << ((0u - rotation) & 31u));
+    }
+
+    // Uniform integer in [Min, Max] (Both included)
+    int range(int Min, int Max) {
+        std::uint32_t bound = std::uint32_t(Max - Min) + 1u;
+        if (bound == 0) {
+            return int(next()); // Whole 32 bit range
+        }
+        // Reject the few values that would make the modulo uneven
+        std::uint32_t threshold = (0u - bound) % bound;
+        for (;;) {
+            std::uint32_t value = next();
+            if (value >= threshold) {
+                return Min + int(value % bound);
+            }
+        }
+    }
+
+    // Uniform float in [0, 1)
+    float nextFloat() {
+        return (next() >> 8) * (1.0f / 16777216.0f);
+    }
+};
+
+// Parts of the simulation that draw random numbers (Each has its own stream)
+enum class RandomStream { Spawning, Routing, Targeting, Count };
+
+// Random numbers of one match
+/*
+* How to use:
+* RandomService random(seed);
+* int lane = random.stream(RandomStream::Routing).range(0, 2);
+*
+* Every subsystem uses its own stream, so adding a random draw in one subsystem does not
+* change the numbers another subsystem gets.
+*/
+class RandomService {
+private:
+    std::uint64_t matchSeed;
+    Pcg32 streams[int(RandomStream::Count)];
+
+public:
+    explicit RandomService(std::uint64_t seed = 1) {
+        reseed(seed);
+    }
+
+    void reseed(std::uint64_t seed) {
+        matchSeed = seed;
+        for (int i = 0; i < int(RandomStream::Count); ++i) {
+            streams[i].reseed(seed, std::uint64_t(i));
+        }
+    }
+
+    Pcg32& stream(RandomStream which) { return streams[int(which)]; }
+    std::uint64_t getSeed() const { return matchSeed; }
+};
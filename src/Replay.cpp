@@ -0,0 +1,173 @@
+#include "Replay.h"
+#include "BinaryStream.h"
+
+#include <cmath>
+#include <iostream>
+
+bool Replay::save(const std::string& filename) const {
+    BinaryWriter writer;
+    writer.write<std::uint32_t>(REPLAY_MAGIC);
+    writer.write<std::uint16_t>(REPLAY_VERSION);
+    writer.write<std::uint64_t>(seed);
+    writer.write<float>(tickRate);
+    writer.write<std::uint64_t>(totalTicks);
+    map.writeTo(writer);
+    archetypes.writeTo(writer);
+
+    writer.write<std::uint32_t>(std::uint32_t(commands.size()));
+    std::uint64_t previousTick = 0;
+    for (const ReplayCommand& recorded : commands) {
+        const SimCommand& command = recorded.command;
+        writer.writeVarint(recorded.tick - previousTick);
+        previousTick = recorded.tick;
+        writer.write<std::uint8_t>(std::uint8_t(command.type));
+        switch (command.type) {
+        case SimCommandType::PlaceTower:
+            writer.write<std::uint8_t>(std::uint8_t(command.towerType));
+            writer.write<float>(command.position.x);
+            writer.write<float>(command.position.y);
+            break;
+        case SimCommandType::UpgradeTower:
+        case SimCommandType::SellTower:
+            writer.write<float>(command.position.x);
+            writer.write<float>(command.position.y);
+            break;
+        case SimCommandType::SetPaused:
+            writer.write<std::uint8_t>(command.paused ? 1 : 0);
+            break;
+        }
+    }
+
+    if (!writer.saveTo(filename)) {
+        std::cerr << "Cannot write replay " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Replay::load(const std::string& filename) {
+    BinaryReader reader;
+    if (!reader.loadFrom(filename)) {
+        std::cerr << "Cannot open replay " << filename << std::endl;
+        return false;
+    }
+    std::uint32_t magic = reader.read<std::uint32_t>();
+    std::uint16_t version = reader.read<std::uint16_t>();
+    if (magic != REPLAY_MAGIC || version < 1 || version > REPLAY_VERSION) {
+        std::cerr << filename << " is not a replay of this version" << std::endl;
+        return false;
+    }
+    seed = reader.read<std::uint64_t>();
+    tickRate = reader.read<float>();
+    totalTicks = reader.read<std::uint64_t>();
+
+    std::string error;
+    if (version >= 3) {
+        map.readFrom(reader, version >= 4); // Spawn and next lines since version 4
+    }
+    else {
+        std::uint32_t waypointCount = reader.read<std::uint32_t>();
+        std::vector<Vec2> path;
+        for (std::uint32_t i = 0; i < waypointCount && reader.isOk(); ++i) {
+            float x = reader.read<float>();
+            float y = reader.read<float>();
+            path.push_back(Vec2(x, y));
+        }
+        map = GameMap();
+        map.name = filename;
+        map.paths.push_back(MapPath{ "main", path });
+    }
+    bool mapOk = reader.isOk() && map.finish(error);
+    archetypes = ArchetypeTable();
+    if (version >= 2 && !archetypes.readFrom(reader)) {
+        std::cerr << filename << ": bad tower or enemy stats" << std::endl;
+        return false;
+    }
+
+    std::uint32_t commandCount = reader.read<std::uint32_t>();
+    commands.clear();
+    std::uint64_t tick = 0;
+    for (std::uint32_t i = 0; i < commandCount && reader.isOk(); ++i) {
+        ReplayCommand recorded;
+        tick += reader.readVarint();
+        recorded.tick = tick;
+        SimCommand& command = recorded.command;
+        command.type = SimCommandType(reader.read<std::uint8_t>());
+        switch (command.type) {
+        case SimCommandType::PlaceTower:
+            command.towerType = TowerType(reader.read<std::uint8_t>());
+            command.position.x = reader.read<float>();
+            command.position.y = reader.read<float>();
+            if (int(command.towerType) >= TOWER_TYPE_COUNT) {
+                std::cerr << filename << ": unknown tower type " << int(command.towerType) << std::endl;
+                return false;
+            }
+            break;
+        case SimCommandType::UpgradeTower:
+        case SimCommandType::SellTower:
+            command.position.x = reader.read<float>();
+            command.position.y = reader.read<float>();
+            break;
+        case SimCommandType::SetPaused:
+            command.paused = reader.read<std::uint8_t>() != 0;
+            break;
+        default:
+            std::cerr << filename << ": unknown command " << int(command.type) << std::endl;
+            return false;
+        }
+        if (command.type != SimCommandType::SetPaused && (!std::isfinite(command.position.x) || !std::isfinite(command.position.y))) {
+            std::cerr << filename << ": bad command position" << std::endl;
+            return false;
+        }
+        commands.push_back(recorded);
+    }
+
+    if (!reader.isOk() || !mapOk || !(std::isfinite(tickRate) && tickRate > 0.0f)) {
+        std::cerr << filename << " is damaged" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void ReplayRecorder::start(const std::string& replayFilename, const GameMap& map, std::uint64_t seed, float tickRate, const ArchetypeTable& archetypes) {
+    filename = replayFilename;
+    replay = Replay();
+    replay.map = map;
+    replay.seed = seed;
+    replay.tickRate = tickRate;
+    replay.archetypes = archetypes;
+    recording = true;
+}
+
+void ReplayRecorder::record(std::uint64_t tick, const SimCommand& command) {
+    if (recording) {
+        ReplayCommand recorded;
+        recorded.tick = tick;
+        recorded.command = command;
+        replay.commands.push_back(recorded);
+    }
+}
+
+void ReplayRecorder::finish(std::uint64_t totalTicks) {
+    if (!recording) {
+        return;
+    }
+    recording = false;
+    replay.totalTicks = totalTicks;
+    if (replay.save(filename)) {
+        std::cout << "Replay written to " << filename << " (" << totalTicks << " ticks, " << replay.commands.size() << " commands)" << std::endl;
+    }
+}
+
+bool ReplayPlayer::step(Simulation& simulation) {
+    if (isFinished()) {
+        return false;
+    }
+    while (nextCommand < replay.commands.size() && replay.commands[nextCommand].tick <= tick) {
+        simulation.apply(replay.commands[nextCommand].command);
+        nextCommand++;
+    }
+    simulation.tick(1.0f / replay.tickRate);
+    tick++;
+    return true;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Simulation.h"
+
+// Replay file ("TDRP", version 4)
+/*
+* Same map, seed, tick rate, archetypes and player commands at the same ticks always give the
+* same match (See Simulation), so that is all a replay stores:
+*   u32 magic, u16 version, u64 seed, f32 tick rate, u64 total ticks
+*   map (See GameMap::writeTo, versions 1 and 2 store the waypoints of one path: u32 count, f32 x y,
+*   version 3 has no spawn and next lines)
+*   archetypes (See ArchetypeTable::writeTo, version 1 replays use the built-in stats)
+*   u32 command count, then for every command:
+*   varint ticks since the previous command, u8 type, then
+*     PlaceTower: u8 tower type, f32 x, f32 y
+*     UpgradeTower / SellTower: f32 x, f32 y
+*     SetPaused: u8 paused
+* A command is run before the tick with its number (Tick 0 = before the first tick).
+*
+* How to use:
+* Replay replay;
+* if (replay.load("match.tdrp")) {
+*     Simulation simulation(replay.map, replay.seed, replay.archetypes);
+*     ReplayPlayer player(replay);
+*     while (player.step(simulation)) {}   // As fast as possible
+* }
+*/
+const std::uint32_t REPLAY_MAGIC = 0x50524454; // "TDRP"
+const std::uint16_t REPLAY_VERSION = 4;
+
+struct ReplayCommand {
+    std::uint64_t tick;
+    SimCommand command;
+};
+
+struct Replay {
+    GameMap map;
+    std::uint64_t seed = 1;
+    float tickRate = 60.0f;
+    ArchetypeTable archetypes;
+    std::uint64_t totalTicks = 0;          // Length of the match that was recorded
+    std::vector<ReplayCommand> commands;   // Ordered by tick
+
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename);
+};
+
+// Record the commands of a match as they are run
+class ReplayRecorder {
+private:
+    Replay replay;
+    std::string filename;
+    bool recording;
+
+public:
+    ReplayRecorder() : recording(false) {}
+
+    void start(const std::string& replayFilename, const GameMap& map, std::uint64_t seed, float tickRate, const ArchetypeTable& archetypes);
+    void record(std::uint64_t tick, const SimCommand& command);
+
+    // Write the file (Does nothing if not recording)
+    void finish(std::uint64_t totalTicks);
+
+    bool isRecording() const { return recording; }
+};
+
+// Run a replay on a simulation, one tick at a time
+class ReplayPlayer {
+private:
+    const Replay& replay;
+    std::size_t nextCommand;
+    std::uint64_t tick;
+
+public:
+    explicit ReplayPlayer(const Replay& replay) : replay(replay), nextCommand(0), tick(0) {}
+
+    // Run the commands of the next tick and the tick, return false once the replay is over
+    bool step(Simulation& simulation);
+
+    bool isFinished() const { return tick >= replay.totalTicks; }
+    std::uint64_t getTick() const { return tick; }
+};
@@ -0,0 +1,705 @@
+#include "Simulation.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "JobSystem.h"
+#include "BinaryStream.h"
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+// Target search of every tower type (Indexed by TowerType)
+static const TargetFunction towerTargeting[TOWER_TYPE_COUNT] = {
+    targetFunctionOf<TowerType::Basic>(),
+    targetFunctionOf<TowerType::Rapid>(),
+    targetFunctionOf<TowerType::Sniper>()
+};
+
+// Path of the built-in levels
+static const std::vector<Vec2> builtinPaths[5] = {
+    { //default map
+        Vec2(0, 100),
+        Vec2(200, 100),
+        Vec2(200, 200),
+        Vec2(400, 200),
+        Vec2(400, 100),
+        Vec2(600, 100),
+        Vec2(600, 300),
+        Vec2(400, 300),
+        Vec2(400, 400),
+        Vec2(200, 400),
+        Vec2(200, 500),
+        Vec2(800, 500)
+    },
+    {
+        Vec2(0, 100),
+        Vec2(700, 100),
+        Vec2(700, 200),
+        Vec2(100, 200),
+        Vec2(100, 300),
+        Vec2(700, 300),
+        Vec2(700, 400),
+        Vec2(100, 400),
+        Vec2(100, 500),
+        Vec2(800, 500)
+    },
+    {
+        Vec2(0, 100),
+        Vec2(600, 300),
+        Vec2(300, 150),
+        Vec2(150, 300),
+        Vec2(400, 300),
+        Vec2(200, 600),
+    },
+    {
+        Vec2(0, 150),
+        Vec2(600, 150),
+        Vec2(600, 75),
+        Vec2(200, 75),
+        Vec2(200, 400),
+        Vec2(50, 400),
+        Vec2(50, 300),
+        Vec2(575, 300),
+        Vec2(575, 200),
+        Vec2(700, 200),
+        Vec2(700, 500),
+        Vec2(300, 500),
+        Vec2(300, 600)
+    },
+    {
+        Vec2(0, 300),
+        Vec2(200, 300),
+        Vec2(200, 150),
+        Vec2(350, 150),
+        Vec2(350, 300),
+        Vec2(500, 300),
+        Vec2(500, 450),
+        Vec2(650, 450),
+        Vec2(650, 300),
+        Vec2(700, 300),
+        Vec2(650, 300),
+        Vec2(650, 450),
+        Vec2(500, 450),
+        Vec2(500, 300),
+        Vec2(350, 300),
+        Vec2(350, 150),
+        Vec2(200, 150),
+        Vec2(200, 300),
+        Vec2(0, 300)
+    }
+};
+
+const GameMap& Simulation::builtinMap(int level) {
+    // Made on first use
+    static const std::vector<GameMap> maps = [] {
+        std::vector<GameMap> built;
+        for (int i = 0; i < 5; ++i) {
+            built.push_back(GameMap::fromPath(builtinPaths[i], "Level " + std::to_string(i + 1)));
+        }
+        return built;
+    }();
+    return maps[level];
+}
+
+int Simulation::builtinMapCount() {
+    return 5;
+}
+
+Simulation::Simulation(const GameMap& map, std::uint64_t seed, const ArchetypeTable& archetypes)
+    : map(map), enemyGrid(map.width, map.height, GRID_CELL_SIZE),
+    bullets(MAX_BULLETS), random(seed), archetypes(archetypes), eventIndex(0),
+    playerLife(100), playerMoney(500), enemyKills(0), gameOver(false), paused(false),
+    waveNumber(1), bossSpawned(false), spawnTimer(0), spawnInterval(2.0f),
+    difficultyTimer(0.0f), healthMultiplier(1.0f), spawnRateMultiplier(1.0f) {
+    for (const Path& route : map.routes) {
+        paths.add(route);
+    }
+}
+
+void Simulation::tick(float deltaTime) {
+    if (gameOver || paused) {
+        return; // Nothing moves after the game is over or while paused
+    }
+
+    difficultyTimer += deltaTime;
+    if (difficultyTimer >= 30.0f) { // Every 30 seconds
+        healthMultiplier += 0.2f;        // Increase enemy health by 20%
+        spawnRateMultiplier *= 0.9f;     // Make spawn interval faster by 10%
+        spawnInterval *= spawnRateMultiplier; // Update the spawn interval
+        difficultyTimer = 0.0f;          // Reset the difficulty timer
+    }
+
+    spawnTimer += deltaTime;
+    if (spawnTimer >= spawnInterval) {
+        spawnEnemy();
+        spawnTimer = 0;
+    }
+
+    // Stages of the tick (See TaskGraph in JobSystem.h)
+    /*
+    * save enemy positions ----------------------------------------------> move enemies -> remove enemies
+    * build grid -> aim towers ---------> fire towers -> find bullet hits -> apply bullet hits -^
+    * save bullet positions -> move bullets -^
+    *
+    * Stages that write shared state (bullets, events, money, removals) run on one thread in
+    * index order, so the match is the same with any number of threads.
+    */
+    std::size_t firstNewBullet = 0;
+
+    // Remember where everything was, the front end draws between the previous and current position
+    auto saveEnemies = [&] {
+        enemies.previousX = enemies.positionX;
+        enemies.previousY = enemies.positionY;
+    };
+    auto saveBullets = [&] {
+        bullets.previousX = bullets.positionX;
+        bullets.previousY = bullets.positionY;
+    };
+    auto buildGrid = [&] {
+        ScopedTimer timer(ProfileZone::TowerTargeting);
+        enemyGrid.build(enemies);
+    };
+    auto aimTowers = [&] {
+        ScopedTimer timer(ProfileZone::TowerTargeting);
+        towerTargets.resize(towers.size());
+        JobSystem::get().parallelFor(towers.size(), TOWER_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                towerTargets[i] = aimTower(towers[i], deltaTime);
+            }
+        });
+    };
+    auto moveBullets = [&] {
+        ScopedTimer timer(ProfileZone::BulletCollision);
+        JobSystem::get().parallelFor(bullets.size(), BULLET_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+            moveBulletRange(begin, end, deltaTime);
+        });
+    };
+    auto fireTowers = [&] {
+        ScopedTimer timer(ProfileZone::TowerTargeting);
+        firstNewBullet = bullets.size();
+        for (std::size_t i = 0; i < towers.size(); ++i) {
+            fireTower(i, towerTargets[i]);
+        }
+    };
+    auto findBulletHits = [&] {
+        ScopedTimer timer(ProfileZone::BulletCollision);
+        bulletHits.resize(bullets.size());
+        JobSystem::get().parallelFor(bullets.size(), BULLET_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+            // Bullets fired this tick move too
+            moveBulletRange((begin > firstNewBullet) ? begin : firstNewBullet, (end > firstNewBullet) ? end : firstNewBullet, deltaTime);
+            for (std::size_t b = begin; b < end; ++b) {
+                bulletHits[b] = findBulletHit(bullets.positionX[b], bullets.positionY[b]);
+            }
+        });
+    };
+    auto applyBulletHits = [&] {
+        ScopedTimer timer(ProfileZone::BulletCollision);
+        resolveBullets();
+    };
+    auto moveEnemies = [&] {
+        ScopedTimer timer(ProfileZone::EnemyMovement);
+        JobSystem::get().parallelFor(enemies.size(), ENEMY_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                updateEnemy(i, deltaTime);
+            }
+        });
+    };
+    auto removeEnemies = [&] {
+        ScopedTimer timer(ProfileZone::EnemyMovement);
+        for (std::size_t i = 0; i < enemies.size();) {
+            if (!enemies.alive[i]) {
+                playerMoney += 50; // Increase player's money when an enemy is killed
+                enemyKills++;
+                pushEvent(SimEventType::EnemyKilled);
+                enemies.remove(i); // Last enemy moves into index i, so check i again
+            }
+            else if (enemies.distance[i] >= paths.length(enemies.path[i])) {
+                playerLife -= 10; // Decrease player's life when an enemy reaches the end
+                pushEvent(SimEventType::EnemyReachedEnd);
+                enemies.remove(i);
+            }
+            else {
+                ++i;
+            }
+        }
+    };
+
+    TaskGraph graph;
+    int saveEnemiesTask = graph.add("Save enemy positions", saveEnemies);
+    int saveBulletsTask = graph.add("Save bullet positions", saveBullets);
+    int buildGridTask = graph.add("Build enemy grid", buildGrid);
+    int aimTask = graph.add("Aim towers", aimTowers);
+    int moveBulletsTask = graph.add("Move bullets", moveBullets);
+    int fireTask = graph.add("Fire towers", fireTowers);
+    int findHitsTask = graph.add("Find bullet hits", findBulletHits);
+    int applyHitsTask = graph.add("Apply bullet hits", applyBulletHits);
+    int moveEnemiesTask = graph.add("Move enemies", moveEnemies);
+    int removeEnemiesTask = graph.add("Remove enemies", removeEnemies);
+    graph.dependsOn(aimTask, buildGridTask);
+    graph.dependsOn(moveBulletsTask, saveBulletsTask);
+    graph.dependsOn(fireTask, aimTask);
+    graph.dependsOn(fireTask, moveBulletsTask);
+    graph.dependsOn(findHitsTask, fireTask);
+    graph.dependsOn(applyHitsTask, findHitsTask);
+    graph.dependsOn(moveEnemiesTask, applyHitsTask);
+    graph.dependsOn(moveEnemiesTask, saveEnemiesTask);
+    graph.dependsOn(removeEnemiesTask, moveEnemiesTask);
+    graph.run();
+
+    // Check if player's life reaches zero
+    if (playerLife <= 0) {
+        gameOver = true;
+        pushEvent(SimEventType::GameOver);
+    }
+}
+
+bool Simulation::placeTower(TowerType type, Vec2 position) {
+    int towerCost = getTowerCost(type);
+    if (playerMoney < towerCost || !map.canBuildAt(position)) {
+        return false;
+    }
+    towers.push_back(makeTower(type, position));
+    playerMoney -= towerCost;
+    return true;
+}
+
+bool Simulation::upgradeTower(std::size_t index) {
+    SimTower& tower = towers[index];
+    int upgradeCost = getUpgradeCost(tower);
+    if (playerMoney < upgradeCost) {
+        return false;
+    }
+    const TowerArchetype& archetype = archetypes.tower(tower.type);
+    tower.level++;
+    tower.damage += archetype.upgradeDamage;
+    tower.range += archetype.upgradeRange;
+    tower.attackCooldown *= archetype.upgradeCooldown;
+    playerMoney -= upgradeCost;
+    return true;
+}
+
+void Simulation::sellTower(std::size_t index) {
+    playerMoney += getTowerCost(towers[index].type) / 2;
+    towers.erase(towers.begin() + index);
+}
+
+void Simulation::apply(const SimCommand& command) {
+    switch (command.type) {
+    case SimCommandType::PlaceTower:
+        if (!map.canBuildAt(command.position)) {
+            pushEvent(SimEventType::CannotBuildHere);
+        }
+        else if (placeTower(command.towerType, command.position)) {
+            pushEvent(SimEventType::TowerPlaced, command.towerType, towers.size() - 1);
+        }
+        else {
+            pushEvent(SimEventType::NotEnoughMoney);
+        }
+        break;
+    case SimCommandType::UpgradeTower: {
+        int index = findTowerAt(command.position);
+        if (index < 0) {
+            break; // Sold before the command arrived
+        }
+        if (upgradeTower(index)) {
+            pushEvent(SimEventType::TowerUpgraded, towers[index].type, index);
+        }
+        else {
+            pushEvent(SimEventType::NotEnoughMoney);
+        }
+        break;
+    }
+    case SimCommandType::SellTower: {
+        int index = findTowerAt(command.position);
+        if (index >= 0) {
+            TowerType type = towers[index].type;
+            sellTower(index);
+            pushEvent(SimEventType::TowerSold, type, index);
+        }
+        break;
+    }
+    case SimCommandType::SetPaused:
+        paused = command.paused;
+        break;
+    }
+}
+
+bool Simulation::saveState(const std::string& filename) const {
+    BinaryWriter writer;
+    writeState(writer);
+    if (!writer.saveTo(filename)) {
+        std::cerr << "Cannot write save " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Simulation::loadState(const std::string& filename, bool sameMapOnly) {
+    BinaryReader reader;
+    if (!reader.loadFrom(filename)) {
+        std::cerr << "Cannot open save " << filename << std::endl;
+        return false;
+    }
+    if (!readState(reader, sameMapOnly)) {
+        std::cerr << filename << " is not a save of this version or is damaged" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Field by field, so the padding of SimTower never reaches the file (Same match, same bytes)
+static void writeTowers(BinaryWriter& writer, const std::vector<SimTower>& towers) {
+    writer.write<std::uint32_t>(std::uint32_t(towers.size()));
+    for (const SimTower& tower : towers) {
+        writer.write<float>(tower.position.x);
+        writer.write<float>(tower.position.y);
+        writer.write<std::uint8_t>(std::uint8_t(tower.type));
+        writer.write<float>(tower.range);
+        writer.write<float>(tower.attackTimer);
+        writer.write<float>(tower.attackCooldown);
+        writer.write<float>(tower.radius);
+        writer.write<std::int32_t>(tower.damage);
+        writer.write<std::int32_t>(tower.level);
+    }
+}
+
+static void readTowers(BinaryReader& reader, std::vector<SimTower>& towers) {
+    std::uint32_t count = reader.read<std::uint32_t>();
+    towers.clear();
+    for (std::uint32_t i = 0; i < count && reader.isOk(); ++i) {
+        SimTower tower;
+        tower.position.x = reader.read<float>();
+        tower.position.y = reader.read<float>();
+        tower.type = TowerType(reader.read<std::uint8_t>());
+        tower.range = reader.read<float>();
+        tower.attackTimer = reader.read<float>();
+        tower.attackCooldown = reader.read<float>();
+        tower.radius = reader.read<float>();
+        tower.damage = reader.read<std::int32_t>();
+        tower.level = reader.read<std::int32_t>();
+        towers.push_back(tower);
+    }
+}
+
+void Simulation::writeState(BinaryWriter& writer) const {
+    writer.write<std::uint32_t>(SAVE_MAGIC);
+    writer.write<std::uint16_t>(SAVE_VERSION);
+    writer.write<std::uint16_t>(0);
+
+    map.writeTo(writer);
+    writer.write<RandomService>(random);
+
+    writer.write<std::int32_t>(playerLife);
+    writer.write<std::int32_t>(playerMoney);
+    writer.write<std::int32_t>(enemyKills);
+    writer.write<std::int32_t>(waveNumber);
+    writer.write<std::uint8_t>(gameOver ? 1 : 0);
+    writer.write<std::uint8_t>(bossSpawned ? 1 : 0);
+    writer.write<float>(spawnTimer);
+    writer.write<float>(spawnInterval);
+    writer.write<float>(difficultyTimer);
+    writer.write<float>(healthMultiplier);
+    writer.write<float>(spawnRateMultiplier);
+
+    writeTowers(writer, towers);
+    enemies.writeTo(writer);
+    bullets.writeTo(writer);
+}
+
+bool Simulation::readState(BinaryReader& reader, bool sameMapOnly) {
+    if (reader.read<std::uint32_t>() != SAVE_MAGIC || reader.read<std::uint16_t>() != SAVE_VERSION) {
+        return false;
+    }
+    reader.read<std::uint16_t>();
+
+    // Read everything aside first, so a damaged save does not leave half a match behind
+    GameMap savedMap;
+    std::string error;
+    if (!savedMap.readFrom(reader) || !savedMap.finish(error)) {
+        return false;
+    }
+    RandomService savedRandom = reader.read<RandomService>();
+
+    int savedLife = reader.read<std::int32_t>();
+    int savedMoney = reader.read<std::int32_t>();
+    int savedKills = reader.read<std::int32_t>();
+    int savedWave = reader.read<std::int32_t>();
+    bool savedGameOver = reader.read<std::uint8_t>() != 0;
+    bool savedBossSpawned = reader.read<std::uint8_t>() != 0;
+    float savedSpawnTimer = reader.read<float>();
+    float savedSpawnInterval = reader.read<float>();
+    float savedDifficultyTimer = reader.read<float>();
+    float savedHealthMultiplier = reader.read<float>();
+    float savedSpawnRateMultiplier = reader.read<float>();
+
+    std::vector<SimTower> savedTowers;
+    readTowers(reader, savedTowers);
+    EnemyPool savedEnemies;
+    BulletPool savedBullets(MAX_BULLETS);
+    if (!savedEnemies.readFrom(reader) || !savedBullets.readFrom(reader) || !reader.isOk()) {
+        return false;
+    }
+
+    // Keep the map and path registry when the layout is the same (References to them stay valid)
+    bool sameMap = savedMap.sameLayout(map);
+    if (!sameMap && sameMapOnly) {
+        return false;
+    }
+    const GameMap& newMap = sameMap ? map : savedMap;
+    for (const SimTower& tower : savedTowers) {
+        // Same limits as towers placed in the match (Positions go into the enemy grid as ints)
+        bool finite = std::isfinite(tower.position.x) && std::isfinite(tower.position.y) && std::isfinite(tower.range) &&
+            std::isfinite(tower.attackTimer) && std::isfinite(tower.attackCooldown) && std::isfinite(tower.radius);
+        if (int(tower.type) >= TOWER_TYPE_COUNT || !finite ||
+            !(tower.position.x >= 0.0f && tower.position.x <= newMap.width && tower.position.y >= 0.0f && tower.position.y <= newMap.height) ||
+            tower.level < 1 || tower.range < 0.0f || tower.radius < 0.0f || tower.attackCooldown < 0.0f) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < savedEnemies.size(); ++i) {
+        if (savedEnemies.path[i] >= newMap.routes.size() || savedEnemies.segment[i] >= newMap.routes[savedEnemies.path[i]].segmentLength.size() ||
+            !std::isfinite(savedEnemies.distance[i]) || savedEnemies.distance[i] < 0.0f) {
+            return false;
+        }
+    }
+
+    if (!sameMap) {
+        map = std::move(savedMap);
+        paths = PathRegistry();
+        for (const Path& route : map.routes) {
+            paths.add(route);
+        }
+        enemyGrid = SpatialGrid(map.width, map.height, GRID_CELL_SIZE);
+    }
+    random = savedRandom;
+    playerLife = savedLife;
+    playerMoney = savedMoney;
+    enemyKills = savedKills;
+    waveNumber = savedWave;
+    gameOver = savedGameOver;
+    bossSpawned = savedBossSpawned;
+    spawnTimer = savedSpawnTimer;
+    spawnInterval = savedSpawnInterval;
+    difficultyTimer = savedDifficultyTimer;
+    healthMultiplier = savedHealthMultiplier;
+    spawnRateMultiplier = savedSpawnRateMultiplier;
+    towers.swap(savedTowers);
+    enemies = std::move(savedEnemies);
+    bullets = std::move(savedBullets);
+    events.clear();
+    eventIndex = 0;
+    return true;
+}
+
+int Simulation::findTowerAt(const std::vector<SimTower>& towers, Vec2 point) {
+    for (std::size_t i = 0; i < towers.size(); ++i) {
+        // Same as the bounding box of the tower circle
+        Vec2 offset = point - towers[i].position;
+        float radius = towers[i].radius;
+        if (offset.x >= -radius && offset.x < radius && offset.y >= -radius && offset.y < radius) {
+            return int(i);
+        }
+    }
+    return -1;
+}
+
+bool Simulation::pollEvent(SimEvent& event) {
+    if (eventIndex >= events.size()) {
+        events.clear();
+        eventIndex = 0;
+        return false;
+    }
+    event = events[eventIndex++];
+    return true;
+}
+
+SimTower Simulation::makeTower(TowerType type, Vec2 position) const {
+    const TowerArchetype& archetype = archetypes.tower(type);
+    SimTower tower;
+    tower.position = position;
+    tower.type = type;
+    tower.attackTimer = 0;
+    tower.level = 1;
+    tower.range = archetype.range;
+    tower.damage = archetype.damage;
+    tower.attackCooldown = archetype.attackCooldown;
+    tower.radius = archetype.radius;
+    return tower;
+}
+
+void Simulation::setArchetypes(const ArchetypeTable& table) {
+    archetypes = table;
+    for (SimTower& tower : towers) {
+        SimTower updated = makeTower(tower.type, tower.position);
+        const TowerArchetype& archetype = archetypes.tower(tower.type);
+        for (int level = 1; level < tower.level; ++level) {
+            updated.damage += archetype.upgradeDamage;
+            updated.range += archetype.upgradeRange;
+            updated.attackCooldown *= archetype.upgradeCooldown;
+        }
+        updated.level = tower.level;
+        updated.attackTimer = tower.attackTimer;
+        tower = updated;
+    }
+    for (std::size_t i = 0; i < enemies.size(); ++i) {
+        enemies.speed[i] = archetypes.enemy(enemies.type[i]).speed;
+    }
+}
+
+void Simulation::spawnEnemy() {
+    TraceScope trace("spawnEnemy");
+    EnemyType type;
+    if (!bossSpawned && waveNumber % 5 == 0) {
+        // Spawn boss enemy
+        type = EnemyType::Boss;
+        bossSpawned = true;
+    }
+    else if (waveNumber % 3 == 0) {
+        // Fast enemy with low health
+        type = EnemyType::Fast;
+    }
+    else if (waveNumber % 3 == 1) {
+        // Slow enemy with high health
+        type = EnemyType::Slow;
+    }
+    else {
+        // Normal enemy
+        type = EnemyType::Normal;
+    }
+    addEnemy(type, 0.0f, chooseRoute());
+
+    waveNumber++;
+}
+
+// Route of a new enemy, picked by the weights of the map
+PathId Simulation::chooseRoute() {
+    if (map.routes.size() < 2) {
+        return 0; // No random number drawn, so one-path maps give the same match as before
+    }
+    float pick = random.stream(RandomStream::Routing).nextFloat();
+    for (std::size_t i = 0; i + 1 < map.routeWeights.size(); ++i) {
+        pick -= map.routeWeights[i];
+        if (pick < 0.0f) {
+            return PathId(i);
+        }
+    }
+    return PathId(map.routeWeights.size() - 1);
+}
+
+void Simulation::addEnemy(EnemyType type, float distance, PathId route) {
+    const EnemyArchetype& archetype = archetypes.enemy(type);
+
+    const Path& path = paths.get(route);
+    std::uint32_t segment = 0;
+    Vec2 start = path.positionAt(distance, segment);
+    enemies.add(type, route, start.x, start.y, archetype.speed, archetype.health);
+    enemies.distance.back() = distance;
+    enemies.segment.back() = segment;
+}
+
+void Simulation::addTower(TowerType type, Vec2 position) {
+    towers.push_back(makeTower(type, position));
+}
+
+std::uint32_t Simulation::aimTower(SimTower& tower, float deltaTime) const {
+    const std::uint32_t noTarget = std::uint32_t(enemies.size());
+    tower.attackTimer += deltaTime;
+    if (tower.attackTimer < tower.attackCooldown) {
+        return noTarget;
+    }
+    // Closest enemy for most towers, the enemy with the highest HP for the sniper (See Targeting.h)
+    return std::uint32_t(towerTargeting[int(tower.type)](enemyGrid, enemies, paths, tower.position, tower.range));
+}
+
+void Simulation::fireTower(std::size_t towerIndex, std::uint32_t targetEnemy) {
+    if (targetEnemy == enemies.size() || bullets.full()) { // Wait if there is no room for another bullet
+        return;
+    }
+    SimTower& tower = towers[towerIndex];
+
+    // Calculate bullet velocity towards the enemy
+    Vec2 direction = Vec2(enemies.positionX[targetEnemy], enemies.positionY[targetEnemy]) - tower.position;
+    float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+    Vec2 velocity = direction / length * 300.0f;
+
+    // Spawn a bullet
+    bullets.add(tower.position.x, tower.position.y, velocity.x, velocity.y, tower.damage);
+    tower.attackTimer = 0;
+
+    pushEvent(SimEventType::TowerFired, tower.type, towerIndex);
+}
+
+void Simulation::moveBulletRange(std::size_t begin, std::size_t end, float deltaTime) {
+    for (std::size_t b = begin; b < end; ++b) {
+        bullets.positionX[b] += bullets.velocityX[b] * deltaTime;
+        bullets.positionY[b] += bullets.velocityY[b] * deltaTime;
+    }
+}
+
+std::uint32_t Simulation::findBulletHit(float x, float y) const {
+    // Check collision with enemies (Bullet box 10x10 against enemy box 20x20)
+    // Only the enemies of the grid cells around the bullet are tested, the one with the
+    // lowest index is hit (Same as testing every enemy in order)
+    const float hitDistance = 15.0f;
+    std::uint32_t hitEnemy = std::uint32_t(enemies.size());
+    enemyGrid.forEachInRect(x - hitDistance, y - hitDistance, x + hitDistance, y + hitDistance, [&](std::uint32_t i) {
+        if (i < hitEnemy && enemies.alive[i] &&
+            std::abs(x - enemies.positionX[i]) < hitDistance &&
+            std::abs(y - enemies.positionY[i]) < hitDistance) {
+            hitEnemy = i;
+        }
+    });
+    return hitEnemy;
+}
+
+void Simulation::resolveBullets() {
+    // Every bullet of every tower in one pass, bulletHits[b] was found before any damage was done
+    for (std::size_t b = 0; b < bullets.size();) {
+        float x = bullets.positionX[b];
+        float y = bullets.positionY[b];
+
+        std::uint32_t hitEnemy = bulletHits[b];
+        if (hitEnemy < enemies.size() && !enemies.alive[hitEnemy]) {
+            hitEnemy = findBulletHit(x, y); // Killed by an earlier bullet, an enemy behind it may be hit instead
+        }
+
+        bool dead = false;
+        if (hitEnemy < enemies.size()) {
+            enemies.health[hitEnemy] -= bullets.damage[b];
+            if (enemies.health[hitEnemy] <= 0) {
+                enemies.alive[hitEnemy] = 0;
+            }
+            enemies.hit[hitEnemy] = 1;
+            dead = true;
+        }
+
+        // Check if bullet is out of bounds
+        if (x < 0 || x > map.width || y < 0 || y > map.height) {
+            dead = true;
+        }
+
+        if (dead) {
+            bulletHits[b] = bulletHits[bullets.size() - 1];
+            bullets.remove(b); // Last bullet moves into index b, so check b again
+        }
+        else {
+            ++b;
+        }
+    }
+}
+
+void Simulation::updateEnemy(std::size_t index, float deltaTime) {
+    const Path& path = paths.get(enemies.path[index]);
+    enemies.distance[index] += enemies.speed[index] * deltaTime;
+    Vec2 position = path.positionAt(enemies.distance[index], enemies.segment[index]);
+    enemies.positionX[index] = position.x;
+    enemies.positionY[index] = position.y;
+}
+
+void Simulation::pushEvent(SimEventType type, TowerType towerType, std::size_t towerIndex) {
+    SimEvent event;
+    event.type = type;
+    event.towerType = towerType;
+    event.towerIndex = towerIndex;
+    events.push_back(event);
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Vec2.h"
+#include "EnemyPool.h"
+#include "BulletPool.h"
+#include "PathRegistry.h"
+#include "GameMap.h"
+#include "SpatialGrid.h"
+#include "Targeting.h"
+#include "Random.h"
+#include "Archetypes.h"
+
+// Headless gameplay core
+/*
+* Everything that decides what happens in a match (enemies, towers, bullets, money, difficulty)
+* lives here and does not use SFML, so a match can be run without a window or audio device.
+*
+* How to use:
+* Simulation simulation(Simulation::builtinMap(level));
+* simulation.tick(deltaTime);                 // Advance the match
+* SimEvent event;
+* while (simulation.pollEvent(event)) {...}   // React to what happened (play audio, ...)
+*/
+
+// Most bullets alive at the same time (Memory of the bullet pool is reserved up front)
+const std::size_t MAX_BULLETS = 8192;
+
+// Cell size of the grid used to find enemies near a point
+const float GRID_CELL_SIZE = 40.0f;
+
+// Saved match ("TDSV", version 4)
+/*
+* Everything needed to go on with the match exactly where it was saved:
+*   u32 magic, u16 version, u16 0
+*   map (See GameMap::writeTo): name, f32 width, height, every path (Name, waypoints), every
+*   spawn (Path name, f32 weight), every next line (From, to, f32 weight), build zones.
+*   Routes and the buildable grid are worked out again from it, not saved
+*   random generator state
+*   i32 life, money, kills, wave, u8 game over, boss spawned, f32 spawn timer, spawn interval,
+*   difficulty timer, health multiplier, spawn rate multiplier
+*   u32 tower count, then every tower (f32 x, y, u8 type, f32 range, attack timer, cooldown,
+*   radius, i32 damage, level), then every array of the enemy pool and the bullet pool (See EnemyPool::writeTo),
+*   the path of an enemy is the index of its route
+* Arrays are raw memory starting at a multiple of 8 bytes, so saving or loading 10000 enemies is
+* a few memcpy. Events not read yet and the paused flag are not saved.
+* Change SAVE_VERSION whenever the layout or a saved struct changes, old saves are then refused.
+*/
+const std::uint32_t SAVE_MAGIC = 0x56534454; // "TDSV"
+const std::uint16_t SAVE_VERSION = 4;
+
+// Towers / bullets / enemies handled by one job (Fewer than this are handled on the calling thread)
+const std::size_t TOWER_CHUNK_SIZE = 32;
+const std::size_t BULLET_CHUNK_SIZE = 256;
+const std::size_t ENEMY_CHUNK_SIZE = 512;
+
+struct SimTower {
+    Vec2 position;
+    TowerType type;
+    float range;
+    float attackTimer;
+    float attackCooldown;
+    float radius;
+    int damage;
+    int level;
+};
+
+// Things that happened during a tick which the front end may want to react to
+enum class SimEventType {
+    TowerFired, EnemyKilled, EnemyReachedEnd, GameOver,
+    TowerPlaced, TowerUpgraded, TowerSold, NotEnoughMoney, CannotBuildHere // Result of a SimCommand
+};
+
+struct SimEvent {
+    SimEventType type;
+    TowerType towerType;    // Only for TowerFired and TowerPlaced
+    std::size_t towerIndex; // Only for TowerFired, TowerPlaced, TowerUpgraded and TowerSold
+};
+
+// Player actions, given to the simulation as data so they can be queued (E.g. from another thread)
+enum class SimCommandType : std::uint8_t { PlaceTower, UpgradeTower, SellTower, SetPaused };
+
+struct SimCommand {
+    SimCommandType type;
+    TowerType towerType = TowerType::Basic; // Only for PlaceTower
+    Vec2 position;                          // Tower position for PlaceTower, clicked point for UpgradeTower and SellTower
+    bool paused = false;                    // Only for SetPaused
+};
+
+class Simulation {
+private:
+    GameMap map;
+    PathRegistry paths;    // Route i of the map is PathId i
+    std::vector<SimTower> towers;
+    std::vector<std::uint32_t> towerTargets; // Enemy every tower wants to shoot this tick (enemies.size() = none)
+    EnemyPool enemies;
+    SpatialGrid enemyGrid; // Rebuilt every tick before the towers update
+    BulletPool bullets;
+    std::vector<std::uint32_t> bulletHits;   // Enemy every bullet touches this tick (enemies.size() = none)
+    RandomService random; // Every random decision of the match comes from here
+    ArchetypeTable archetypes; // Stats of new towers and enemies
+
+    std::vector<SimEvent> events;
+    std::size_t eventIndex;
+
+    int playerLife;
+    int playerMoney;
+    int enemyKills;
+    bool gameOver;
+    bool paused;
+
+    int waveNumber;
+    bool bossSpawned;
+    float spawnTimer;
+    float spawnInterval;
+
+    //variables for tracking difficulty and controling enemy health and spawn rate
+    float difficultyTimer;     // Time elapsed to increase difficulty
+    float healthMultiplier;      // Multiplier to increase enemy health
+    float spawnRateMultiplier;     // Multiplier to make enemies spawn faster
+
+public:
+    // Same map, seed, archetypes and commands give the same match
+    explicit Simulation(const GameMap& map, std::uint64_t seed = 1, const ArchetypeTable& archetypes = ArchetypeTable());
+
+    // Advance the match by deltaTime seconds
+    // (Call it with the same deltaTime every time to get the same match on every machine)
+    void tick(float deltaTime);
+
+    // Player commands (Return false if the player cannot afford it or cannot build there)
+    bool placeTower(TowerType type, Vec2 position);
+    bool upgradeTower(std::size_t index);
+    void sellTower(std::size_t index);
+
+    // Run a queued player command, the result comes out as an event
+    void apply(const SimCommand& command);
+
+    // Save / restore the whole match (Saves, benchmarks starting from a late game)
+    // sameMapOnly: refuse saves made on another map (The front end keeps drawing the current one)
+    // Nothing changes when loading fails
+    bool saveState(const std::string& filename) const;
+    bool loadState(const std::string& filename, bool sameMapOnly = false);
+    void writeState(BinaryWriter& writer) const;
+    bool readState(BinaryReader& reader, bool sameMapOnly = false);
+
+    // Scenario setup for benchmarks and tools (No money is spent, spawning rules are skipped)
+    void addEnemy(EnemyType type, float distance, PathId route = 0);
+    void addTower(TowerType type, Vec2 position);
+    // New stats (Hot reload): towers on the playfield get the stats of their type and level,
+    // enemies on the path get the new speed and keep their health
+    void setArchetypes(const ArchetypeTable& table);
+    const ArchetypeTable& getArchetypes() const { return archetypes; }
+
+    void setLife(int life) { playerLife = life; if (life > 0) gameOver = false; } // A finished match goes on
+
+    // Index of the tower under the point, -1 if there is none
+    int findTowerAt(Vec2 point) const { return findTowerAt(towers, point); }
+    static int findTowerAt(const std::vector<SimTower>& towers, Vec2 point);
+
+    // Get the next event produced by tick(), return false when there is no more
+    bool pollEvent(SimEvent& event);
+
+    const GameMap& getMap() const { return map; }
+    const PathRegistry& getPaths() const { return paths; }
+    const std::vector<SimTower>& getTowers() const { return towers; }
+    const EnemyPool& getEnemies() const { return enemies; }
+    const BulletPool& getBullets() const { return bullets; }
+    int getLife() const { return playerLife; }
+    int getMoney() const { return playerMoney; }
+    int getKills() const { return enemyKills; }
+    int getWaveNumber() const { return waveNumber; }
+    bool isGameOver() const { return gameOver; }
+    bool isPaused() const { return paused; }
+    std::uint64_t getSeed() const { return random.getSeed(); }
+
+    // Tower stats and prices (From the archetypes)
+    SimTower makeTower(TowerType type, Vec2 position) const;
+    int getTowerCost(TowerType type) const { return archetypes.tower(type).cost; }
+    int getUpgradeCost(const SimTower& tower) const { return tower.level * archetypes.tower(tower.type).upgradeCost; }
+
+    // Map of the built-in levels [0, 4] (Used when a level has no map file)
+    static const GameMap& builtinMap(int level);
+    static int builtinMapCount();
+
+private:
+    void spawnEnemy();
+    PathId chooseRoute();
+    std::uint32_t aimTower(SimTower& tower, float deltaTime) const;
+    void fireTower(std::size_t towerIndex, std::uint32_t targetEnemy);
+    void moveBulletRange(std::size_t begin, std::size_t end, float deltaTime);
+    std::uint32_t findBulletHit(float x, float y) const;
+    void resolveBullets();
+    void updateEnemy(std::size_t index, float deltaTime);
+    void pushEvent(SimEventType type, TowerType towerType = TowerType::Basic, std::size_t towerIndex = 0);
+};
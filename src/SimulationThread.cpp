@@ -0,0 +1,189 @@
+#include "SimulationThread.h"
+#include "Profiler.h"
+#include "Trace.h"
+
+#include <chrono>
+#include <iostream>
+
+SimulationThread::SimulationThread(const GameMap& map, std::uint64_t seed, const ArchetypeTable& archetypes, float tickRate, int maxCatchUpTicks)
+    : simulation(map, seed, archetypes), tickRate(tickRate), speed(1.0f), maxCatchUpTicks(maxCatchUpTicks), tickCount(0),
+    running(false), archetypesChanged(false), readIndex(0), replayFinished(false) {
+    // Something to draw before the first tick
+    publishSnapshot();
+}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+void SimulationThread::start() {
+    if (!running.exchange(true)) {
+        thread = std::thread(&SimulationThread::run, this);
+    }
+}
+
+void SimulationThread::stop() {
+    running.store(false);
+    if (thread.joinable()) {
+        thread.join();
+    }
+    recorder.finish(tickCount);
+}
+
+void SimulationThread::startRecording(const std::string& filename) {
+    recorder.start(filename, simulation.getMap(), simulation.getSeed(), tickRate, simulation.getArchetypes());
+}
+
+void SimulationThread::playReplay(const Replay& replayToPlay, float playbackSpeed) {
+    replay = replayToPlay;
+    simulation.setArchetypes(replay.archetypes);
+    replayPlayer.reset(new ReplayPlayer(replay));
+    speed = playbackSpeed;
+}
+
+void SimulationThread::submit(const SimCommand& command) {
+    std::lock_guard<std::mutex> lock(commandMutex);
+    commands.push_back(command);
+}
+
+void SimulationThread::requestSave(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(commandMutex);
+    saveFile = filename;
+}
+
+void SimulationThread::requestLoad(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(commandMutex);
+    loadFile = filename;
+}
+
+bool SimulationThread::setArchetypes(const ArchetypeTable& archetypes) {
+    // Recording and replay only start before start(), so this thread can read them
+    if (replayPlayer || recorder.isRecording()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(commandMutex);
+    newArchetypes = archetypes;
+    archetypesChanged = true;
+    return true;
+}
+
+// Save, load and archetype changes asked by the front end, return true if the match changed
+bool SimulationThread::runRequests() {
+    std::string toSave, toLoad;
+    bool changeArchetypes;
+    ArchetypeTable archetypes;
+    {
+        std::lock_guard<std::mutex> lock(commandMutex);
+        toSave.swap(saveFile);
+        toLoad.swap(loadFile);
+        changeArchetypes = archetypesChanged;
+        archetypes = newArchetypes;
+        archetypesChanged = false;
+    }
+    if (changeArchetypes) {
+        simulation.setArchetypes(archetypes);
+    }
+    if (!toSave.empty() && simulation.saveState(toSave)) {
+        std::cout << "Game saved to " << toSave << std::endl;
+    }
+    if (toLoad.empty()) {
+        return changeArchetypes;
+    }
+    if (replayPlayer || recorder.isRecording()) {
+        std::cerr << "Cannot load a save while recording or playing a replay" << std::endl;
+        return changeArchetypes;
+    }
+    if (!simulation.loadState(toLoad, true)) {
+        return changeArchetypes; // Same map only, the front end keeps drawing the one it has
+    }
+    std::cout << "Game loaded from " << toLoad << std::endl;
+    return true;
+}
+
+bool SimulationThread::pollEvent(SimEvent& event) {
+    if (readIndex >= readEvents.size()) {
+        // Take everything produced since the last time
+        readEvents.clear();
+        readIndex = 0;
+        std::lock_guard<std::mutex> lock(eventMutex);
+        readEvents.swap(events);
+    }
+    if (readIndex >= readEvents.size()) {
+        return false;
+    }
+    event = readEvents[readIndex++];
+    return true;
+}
+
+void SimulationThread::run() {
+    typedef std::chrono::steady_clock Clock;
+    const Clock::duration tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / (tickRate * speed)));
+    const float deltaTime = 1.0f / tickRate;
+    Clock::time_point nextTick = Clock::now() + tickDuration;
+
+    while (running.load()) {
+        if (runRequests()) {
+            publishSnapshot(); // Show the loaded match or new stats even while paused
+        }
+
+        int ticks = 0;
+        while (Clock::now() >= nextTick && ticks < maxCatchUpTicks) {
+            {
+                std::lock_guard<std::mutex> lock(commandMutex);
+                runningCommands.swap(commands);
+            }
+            if (!replayPlayer) {
+                for (const SimCommand& command : runningCommands) {
+                    simulation.apply(command);
+                    recorder.record(tickCount, command);
+                }
+            }
+            runningCommands.clear();
+
+            {
+                ScopedTimer timer(ProfileZone::Update);
+                TraceScope trace("Simulation::tick");
+                if (!replayPlayer) {
+                    simulation.tick(deltaTime);
+                }
+                else if (!replayPlayer->step(simulation)) {
+                    replayFinished.store(true);
+                    nextTick += tickDuration;
+                    break; // End of the replay, keep showing the last tick
+                }
+            }
+            nextTick += tickDuration;
+            tickCount++;
+            ticks++;
+        }
+        if (ticks == maxCatchUpTicks && Clock::now() >= nextTick) {
+            nextTick = Clock::now(); // Too far behind, skip instead of never catching up
+        }
+
+        if (ticks > 0) {
+            // Snapshot first, so every event the front end reads is already in the newest snapshot
+            publishSnapshot();
+            std::lock_guard<std::mutex> lock(eventMutex);
+            SimEvent event;
+            while (simulation.pollEvent(event)) {
+                events.push_back(event);
+            }
+        }
+
+        std::this_thread::sleep_until(nextTick);
+    }
+}
+
+void SimulationThread::publishSnapshot() {
+    SimSnapshot& snapshot = snapshots.writeBuffer();
+    snapshot.enemies = simulation.getEnemies();
+    snapshot.bullets = simulation.getBullets();
+    snapshot.towers = simulation.getTowers();
+    snapshot.life = simulation.getLife();
+    snapshot.money = simulation.getMoney();
+    snapshot.kills = simulation.getKills();
+    snapshot.gameOver = simulation.isGameOver();
+    snapshot.tick = tickCount;
+    snapshot.time = std::chrono::steady_clock::now();
+    snapshots.publish();
+}
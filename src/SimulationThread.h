@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Simulation.h"
+#include "SnapshotBuffer.h"
+#include "Replay.h"
+
+// Simulation running on its own thread at a fixed tick rate
+/*
+* The front end never touches the Simulation: it sends commands, reads events and draws the
+* newest snapshot. So a slow frame (Or waiting for vsync) does not slow the simulation down,
+* and a slow tick does not stop the window from drawing.
+*
+* How to use:
+* SimulationThread simulation(map, seed, archetypes, 60.0f, 5);
+* simulation.start();
+* simulation.submit(command);                                // Player input
+* SimEvent event; while (simulation.pollEvent(event)) {...}  // Audio, ...
+* const SimSnapshot& snapshot = simulation.acquireSnapshot(); // Drawing
+*
+* Before start(), startRecording() saves the commands of the match as a replay when the thread
+* stops, playReplay() runs the commands of a replay instead of the submitted ones.
+*/
+class SimulationThread {
+private:
+    Simulation simulation;     // Only used by the simulation thread after start()
+    float tickRate;
+    float speed;               // Ticks per second = tickRate * speed (The tick length stays 1 / tickRate)
+    int maxCatchUpTicks;
+    std::uint64_t tickCount;   // Ticks run so far
+    std::thread thread;
+    std::atomic<bool> running;
+
+    std::mutex commandMutex;
+    std::vector<SimCommand> commands;        // Sent by the front end, run before the next tick
+    std::vector<SimCommand> runningCommands; // Swapped with commands by the simulation thread
+    std::string saveFile;                    // Save / load asked by the front end (Empty = none)
+    std::string loadFile;
+    ArchetypeTable newArchetypes;            // Hot reload asked by the front end
+    bool archetypesChanged;
+
+    std::mutex eventMutex;
+    std::vector<SimEvent> events;            // Produced by ticks, not read yet
+    std::vector<SimEvent> readEvents;        // Swapped with events by the front end
+    std::size_t readIndex;
+
+    SnapshotBuffer snapshots;
+
+    ReplayRecorder recorder;
+    Replay replay;
+    std::unique_ptr<ReplayPlayer> replayPlayer;
+    std::atomic<bool> replayFinished;
+
+    void run();
+    bool runRequests();
+    void publishSnapshot();
+
+public:
+    SimulationThread(const GameMap& map, std::uint64_t seed, const ArchetypeTable& archetypes, float tickRate, int maxCatchUpTicks);
+    ~SimulationThread();
+
+    void start();
+    void stop();
+
+    void startRecording(const std::string& filename);
+
+    // Simulation must have been created with the map, seed and tick rate of the replay
+    // Commands submitted while playing are ignored
+    void playReplay(const Replay& replayToPlay, float playbackSpeed);
+    bool isReplayFinished() const { return replayFinished.load(); }
+
+    // Run the command on the simulation thread before the next tick
+    void submit(const SimCommand& command);
+
+    // Save / load the whole match on the simulation thread before the next tick (See Simulation::saveState)
+    // Only saves of the same map are loaded, and none while recording or playing a replay
+    void requestSave(const std::string& filename);
+    void requestLoad(const std::string& filename);
+
+    // Use new tower and enemy stats from the next tick on
+    // Return false (Stats not used) while recording or playing a replay, keep showing the old ones then
+    bool setArchetypes(const ArchetypeTable& archetypes);
+
+    // Next event of the simulation, return false when there is no more
+    bool pollEvent(SimEvent& event);
+
+    const SimSnapshot& acquireSnapshot() { return snapshots.acquire(); }
+
+    // Never changed after construction, safe to read from any thread
+    const PathRegistry& getPaths() const { return simulation.getPaths(); }
+    const GameMap& getMap() const { return simulation.getMap(); }
+    float getTickRate() const { return tickRate; }
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+};
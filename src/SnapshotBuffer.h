@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "Simulation.h"
+
+// What the front end needs to draw one tick of the simulation (A copy, never changed after it is published)
+struct SimSnapshot {
+    EnemyPool enemies;
+    BulletPool bullets{ MAX_BULLETS };
+    std::vector<SimTower> towers;
+    int life = 0;
+    int money = 0;
+    int kills = 0;
+    bool gameOver = false;
+    std::uint64_t tick = 0;                        // Ticks simulated before this snapshot
+    std::chrono::steady_clock::time_point time;    // When it was published (For drawing between ticks)
+};
+
+// Triple buffer of snapshots between the simulation thread and the render thread
+/*
+* The writer fills its own snapshot and publishes it, the reader always gets the newest
+* published snapshot. Neither side ever waits for the other: there are three snapshots, one
+* being written, one being read and one in the middle that they swap with.
+* Copying into a snapshot reuses its memory, so after the first ticks nothing is allocated.
+*
+* How to use:
+* SimSnapshot& snapshot = buffer.writeBuffer(); ...fill it...; buffer.publish();   // Writer
+* const SimSnapshot& snapshot = buffer.acquire();                                 // Reader
+*/
+class SnapshotBuffer {
+private:
+    static const int NEW_SNAPSHOT = 4; // Set on middle when it holds a snapshot the reader has not taken
+
+    SimSnapshot snapshots[3];
+    std::atomic<int> middle;  // Index of the middle snapshot (| NEW_SNAPSHOT)
+    int writing;              // Only used by the writer
+    int reading;              // Only used by the reader
+
+public:
+    SnapshotBuffer() : middle(1), writing(0), reading(2) {}
+
+    SimSnapshot& writeBuffer() { return snapshots[writing]; }
+
+    void publish() {
+        writing = middle.exchange(writing | NEW_SNAPSHOT, std::memory_order_acq_rel) & ~NEW_SNAPSHOT;
+    }
+
+    // Newest published snapshot (The same one again if nothing new was published)
+    const SimSnapshot& acquire() {
+        if (middle.load(std::memory_order_relaxed) & NEW_SNAPSHOT) {
+            reading = middle.exchange(reading, std::memory_order_acq_rel) & ~NEW_SNAPSHOT;
+        }
+        return snapshots[reading];
+    }
+};
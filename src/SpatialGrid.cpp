@@ -0,0 +1,36 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float width, float height, float cellSize)
+    : cellSize(cellSize), inverseCellSize(1.0f / cellSize),
+    columns(int(std::ceil(width / cellSize))), rows(int(std::ceil(height / cellSize))) {
+    cellStart.assign(columns * rows + 1, 0);
+    cellFill.assign(columns * rows, 0);
+}
+
+void SpatialGrid::build(const EnemyPool& enemies) {
+    std::size_t count = enemies.size();
+    enemyCell.resize(count);
+    entries.resize(count);
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+
+    // Count the enemies of every cell
+    for (std::size_t i = 0; i < count; ++i) {
+        int cell = rowOf(enemies.positionY[i]) * columns + columnOf(enemies.positionX[i]);
+        enemyCell[i] = std::uint32_t(cell);
+        cellStart[cell + 1]++;
+    }
+
+    // Turn the counts into start offsets
+    for (std::size_t cell = 1; cell < cellStart.size(); ++cell) {
+        cellStart[cell] += cellStart[cell - 1];
+    }
+
+    // Place the enemies (In index order, so every cell lists its enemies by increasing index)
+    std::copy(cellStart.begin(), cellStart.end() - 1, cellFill.begin());
+    for (std::size_t i = 0; i < count; ++i) {
+        entries[cellFill[enemyCell[i]]++] = std::uint32_t(i);
+    }
+}
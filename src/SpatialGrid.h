@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "EnemyPool.h"
+
+// Uniform grid over the playfield to find enemies near a point
+/*
+* The playfield is cut into square cells, build() sorts the enemy indices by cell so that
+* every cell is one contiguous range of indices. Asking for the enemies in an area then only
+* looks at the cells the area touches instead of every enemy.
+* Enemies outside the playfield are put into the nearest border cell.
+*
+* How to use:
+* grid.build(enemies);                     // Once per tick, after enemies moved
+* grid.forEachInRect(minX, minY, maxX, maxY, [&](std::uint32_t index) {...});
+*/
+class SpatialGrid {
+private:
+    float cellSize;
+    float inverseCellSize;
+    int columns;
+    int rows;
+    std::vector<std::uint32_t> cellStart;  // Enemies of cell c are entries[cellStart[c]] ... entries[cellStart[c + 1] - 1]
+    std::vector<std::uint32_t> entries;    // Enemy indices sorted by cell
+    std::vector<std::uint32_t> enemyCell;  // Cell of every enemy (Kept between builds to avoid reallocating)
+    std::vector<std::uint32_t> cellFill;   // Next free entry of every cell while building
+
+public:
+    SpatialGrid(float width, float height, float cellSize);
+
+    // Put every enemy of the pool into its cell
+    void build(const EnemyPool& enemies);
+
+    // Call function(index) for every enemy in the cells touching the rectangle
+    // (Enemies near the rectangle may be included, the caller does the exact test)
+    template <typename Function>
+    void forEachInRect(float minX, float minY, float maxX, float maxY, Function function) const {
+        int firstColumn = columnOf(minX), lastColumn = columnOf(maxX);
+        int firstRow = rowOf(minY), lastRow = rowOf(maxY);
+        for (int row = firstRow; row <= lastRow; ++row) {
+            for (int column = firstColumn; column <= lastColumn; ++column) {
+                int cell = row * columns + column;
+                for (std::uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; ++i) {
+                    function(entries[i]);
+                }
+            }
+        }
+    }
+
+private:
+    int columnOf(float x) const {
+        int column = int(x * inverseCellSize);
+        return (column < 0) ? 0 : ((column >= columns) ? columns - 1 : column);
+    }
+
+    int rowOf(float y) const {
+        int row = int(y * inverseCellSize);
+        return (row < 0) ? 0 : ((row >= rows) ? rows - 1 : row);
+    }
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Vec2.h"
+#include "EnemyPool.h"
+#include "PathRegistry.h"
+#include "SpatialGrid.h"
+
+// Tower kinds (Same order as the tower selection buttons)
+enum class TowerType : std::uint8_t { Basic, Rapid, Sniper };
+const int TOWER_TYPE_COUNT = 3;
+
+// Targeting policies
+/*
+* A policy gives every enemy in range a score, the tower shoots the enemy with the highest
+* score (Ties go to the lowest index). Policies are plain structs used as template
+* parameters, so the search loop is compiled once per policy with the score inlined.
+*/
+struct TargetClosest {
+    static float score(const EnemyPool&, const PathRegistry&, std::uint32_t, float distSq) { return -distSq; }
+};
+
+struct TargetStrongest {
+    static float score(const EnemyPool& enemies, const PathRegistry&, std::uint32_t i, float) { return float(enemies.health[i]); }
+};
+
+struct TargetWeakest {
+    static float score(const EnemyPool& enemies, const PathRegistry&, std::uint32_t i, float) { return -float(enemies.health[i]); }
+};
+
+// Enemy closest to the end of its path
+struct TargetFirst {
+    static float score(const EnemyPool& enemies, const PathRegistry& paths, std::uint32_t i, float) {
+        return enemies.distance[i] - paths.length(enemies.path[i]);
+    }
+};
+
+// Enemy furthest from the end of its path
+struct TargetLast {
+    static float score(const EnemyPool& enemies, const PathRegistry& paths, std::uint32_t i, float) {
+        return paths.length(enemies.path[i]) - enemies.distance[i];
+    }
+};
+
+// Policy of every tower type (Add a specialization for a new tower type)
+template <TowerType Type> struct TowerTargeting;
+template <> struct TowerTargeting<TowerType::Basic> { typedef TargetClosest Policy; };
+template <> struct TowerTargeting<TowerType::Rapid> { typedef TargetClosest Policy; };
+template <> struct TowerTargeting<TowerType::Sniper> { typedef TargetStrongest Policy; };
+
+// Index of the alive enemy within radius with the best score, enemies.size() if none
+template <typename Policy>
+std::size_t findTarget(const SpatialGrid& grid, const EnemyPool& enemies, const PathRegistry& paths, Vec2 center, float radius) {
+    std::size_t best = enemies.size();
+    float bestScore = 0.0f;
+    float radiusSq = radius * radius; // Squared distances, no sqrt needed to compare
+    grid.forEachInRect(center.x - radius, center.y - radius, center.x + radius, center.y + radius, [&](std::uint32_t i) {
+        if (!enemies.alive[i]) {
+            return;
+        }
+        float dx = enemies.positionX[i] - center.x;
+        float dy = enemies.positionY[i] - center.y;
+        float distSq = dx * dx + dy * dy;
+        if (distSq >= radiusSq) {
+            return;
+        }
+        float score = Policy::score(enemies, paths, i, distSq);
+        if (best == enemies.size() || score > bestScore || (score == bestScore && i < best)) {
+            best = i;
+            bestScore = score;
+        }
+    });
+    return best;
+}
+
+typedef std::size_t (*TargetFunction)(const SpatialGrid&, const EnemyPool&, const PathRegistry&, Vec2, float);
+
+// Target search of a tower type
+template <TowerType Type>
+TargetFunction targetFunctionOf() {
+    return &findTarget<typename TowerTargeting<Type>::Policy>;
+}
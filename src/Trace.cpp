@@ -0,0 +1,83 @@
+#include "Trace.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+std::atomic<bool> Tracer::enabled(false);
+
+static std::int64_t nowMicroseconds() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Tracer& Tracer::get() {
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::Tracer() : startTime(nowMicroseconds()) {}
+
+void Tracer::start(const std::string& filename) {
+    Tracer& tracer = get();
+    tracer.filename = filename;
+    tracer.startTime = nowMicroseconds();
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+TraceBuffer& Tracer::threadBuffer() {
+    thread_local TraceBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        // Owned by the tracer, so the events are still there when the thread has ended
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffers.push_back(std::unique_ptr<TraceBuffer>(new TraceBuffer()));
+        buffer = buffers.back().get();
+        buffer->threadId = std::uint32_t(buffers.size());
+    }
+    return *buffer;
+}
+
+void Tracer::record(const char* name, char phase) {
+    TraceBuffer& buffer = threadBuffer();
+    std::uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    TraceRecord& record = buffer.records[index % TRACE_BUFFER_SIZE];
+    record.name = name;
+    record.timestamp = nowMicroseconds() - startTime;
+    record.phase = phase;
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::stop() {
+    if (!enabled.exchange(false)) {
+        return;
+    }
+    Tracer& tracer = get();
+    std::ofstream file(tracer.filename);
+    if (!file) {
+        std::cerr << "Cannot write trace file " << tracer.filename << std::endl;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(tracer.buffersMutex);
+    file << "{\"traceEvents\":[\n";
+    bool first = true;
+    for (const auto& buffer : tracer.buffers) {
+        std::uint64_t written = buffer->written.load(std::memory_order_acquire);
+        std::uint64_t begin = (written > TRACE_BUFFER_SIZE) ? written - TRACE_BUFFER_SIZE : 0;
+        int depth = 0;
+        for (std::uint64_t i = begin; i < written; ++i) {
+            const TraceRecord& record = buffer->records[i % TRACE_BUFFER_SIZE];
+            // The begin event was overwritten, drop the end too
+            if (record.phase == 'E' && depth == 0) {
+                continue;
+            }
+            depth += (record.phase == 'B') ? 1 : -1;
+
+            file << (first ? "" : ",\n")
+                << "{\"name\":\"" << record.name << "\",\"ph\":\"" << record.phase
+                << "\",\"ts\":" << record.timestamp << ",\"pid\":1,\"tid\":" << buffer->threadId << "}";
+            first = false;
+        }
+    }
+    file << "\n]}\n";
+    std::cout << "Trace written to " << tracer.filename << std::endl;
+}
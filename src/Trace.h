@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Events kept per thread (Older events are overwritten when a thread records more)
+const std::uint32_t TRACE_BUFFER_SIZE = 1 << 16;
+
+// One begin or end event
+struct TraceRecord {
+    const char* name;         // String literal, only the pointer is stored
+    std::int64_t timestamp;   // Microseconds since the trace started
+    char phase;               // 'B' = begin, 'E' = end
+};
+
+// Ring buffer of one thread (Only its thread writes, the file is written after recording stopped)
+struct TraceBuffer {
+    std::uint32_t threadId = 0;
+    std::atomic<std::uint64_t> written{ 0 }; // Events ever recorded, the newest is records[(written - 1) % TRACE_BUFFER_SIZE]
+    TraceRecord records[TRACE_BUFFER_SIZE];
+};
+
+// Session tracer writing Chrome trace JSON (Open with chrome://tracing or ui.perfetto.dev)
+/*
+* How to use:
+* Tracer::start("trace.json");              // Once
+* { TraceScope trace("Game::update"); ... } // Record a begin and an end event around a block
+* Tracer::stop();                           // Writes the file, once no other thread records any more
+*
+* While not started a TraceScope only reads one flag.
+* Recording does not lock: every thread gets its own buffer the first time it records.
+*/
+class Tracer {
+private:
+    static std::atomic<bool> enabled;
+
+    std::mutex buffersMutex;          // Only taken when a thread records its first event
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+    std::string filename;
+    std::int64_t startTime;
+
+    Tracer();
+    TraceBuffer& threadBuffer();
+
+public:
+    static Tracer& get();
+
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    // Start recording, the trace is saved to filename by stop()
+    static void start(const std::string& filename);
+
+    // Stop recording and write the file (Safe to call more than once)
+    // Join or stop every thread that records first (Simulation thread, job workers), the buffers are read without locking
+    static void stop();
+
+    void record(const char* name, char phase);
+};
+
+// Begin event on construction, end event on destruction
+class TraceScope {
+private:
+    const char* name;
+
+public:
+    explicit TraceScope(const char* name) : name(Tracer::isEnabled() ? name : nullptr) {
+        if (this->name != nullptr) {
+            Tracer::get().record(this->name, 'B');
+        }
+    }
+
+    ~TraceScope() {
+        if (name != nullptr) {
+            Tracer::get().record(name, 'E');
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+// 2D vector used by the simulation (same meaning as sf::Vector2f)
+struct Vec2 {
+    float x = 0.0f;
+    float y = 0.0f;
+
+    Vec2() {}
+    Vec2(float x, float y) : x(x), y(y) {}
+};
+
+inline Vec2 operator+(const Vec2& a, const Vec2& b) { return Vec2(a.x + b.x, a.y + b.y); }
+inline Vec2 operator-(const Vec2& a, const Vec2& b) { return Vec2(a.x - b.x, a.y - b.y); }
+inline Vec2 operator*(const Vec2& a, float scale) { return Vec2(a.x * scale, a.y * scale); }
+inline Vec2 operator/(const Vec2& a, float scale) { return Vec2(a.x / scale, a.y / scale); }
+inline Vec2& operator+=(Vec2& a, const Vec2& b) { a.x += b.x; a.y += b.y; return a; }
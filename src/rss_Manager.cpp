@@ -0,0 +1,72 @@
+#include "rss_Manager.h"
+
+#include <iostream>
+
+ResourceManager& ResourceManager::get() {
+    static ResourceManager manager;
+    return manager;
+}
+
+template <typename Resource>
+const Resource& ResourceManager::load(std::map<std::string, std::unique_ptr<Resource>>& cache, const std::string& directory, const std::string& filename) {
+    auto found = cache.find(filename);
+    if (found != cache.end()) {
+        return *found->second;
+    }
+
+    // First request: read the file and remember how long it took
+    sf::Clock clock;
+    std::unique_ptr<Resource> resource(new Resource());
+    bool success = resource->loadFromFile(directory + filename);
+    if (!success) {
+        std::cerr << "Failed to load " << directory + filename << std::endl;
+    }
+    LoadRecord record;
+    record.filename = filename;
+    record.milliseconds = clock.getElapsedTime().asMicroseconds() / 1000.0f;
+    record.success = success;
+    loadRecords.push_back(record);
+
+    const Resource& loaded = *resource;
+    cache[filename] = std::move(resource);
+    return loaded;
+}
+
+const sf::Font& ResourceManager::getFont(const std::string& filename) {
+    return load(fonts, FONT_DIRECTORY, filename);
+}
+
+const sf::Image& ResourceManager::getImage(const std::string& filename) {
+    return load(images, TEXTURE_DIRECTORY, filename);
+}
+
+const sf::Texture& ResourceManager::getTexture(const std::string& filename) {
+    return load(textures, TEXTURE_DIRECTORY, filename);
+}
+
+const sf::SoundBuffer& ResourceManager::getSoundBuffer(const std::string& filename) {
+    return load(soundBuffers, AUDIO_DIRECTORY, filename);
+}
+
+bool ResourceManager::isLoaded(const std::string& filename) const {
+    for (const auto& record : loadRecords) {
+        if (record.filename == filename) {
+            return record.success;
+        }
+    }
+    return false;
+}
+
+void ResourceManager::preload() {
+    getFont(DEFAULT_FONT);
+    getImage("icon.jpg");
+}
+
+void ResourceManager::reportLoadTimes(std::ostream& output) const {
+    float total = 0.0f;
+    for (const auto& record : loadRecords) {
+        output << "Loaded " << record.filename << " in " << record.milliseconds << " ms" << (record.success ? "" : " (FAILED)") << std::endl;
+        total += record.milliseconds;
+    }
+    output << "Loaded " << loadRecords.size() << " assets in " << total << " ms" << std::endl;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ostream>
+
+// Asset folders
+const std::string FONT_DIRECTORY = "src/assets/font/";
+const std::string TEXTURE_DIRECTORY = "src/assets/textures/";
+const std::string AUDIO_DIRECTORY = "src/assets/audio/";
+
+// Font used by every screen
+const std::string DEFAULT_FONT = "Roboto-Black.ttf";
+
+// Resource manager (Load every asset from disk once and share it)
+/*
+* How to use:
+* const sf::Font& font = ResourceManager::get().getFont(DEFAULT_FONT);
+*
+* The first call loads the file, later calls return the same object. References stay valid
+* until the program ends. If a file fails to load, an empty resource is kept (and reported
+* once) so callers never have to handle a missing object.
+*/
+class ResourceManager {
+public:
+    // The one manager of the program
+    static ResourceManager& get();
+
+    // File name without folder (E.g. "Roboto-Black.ttf", "icon.jpg", "Pause.wav")
+    const sf::Font& getFont(const std::string& filename);
+    const sf::Image& getImage(const std::string& filename);
+    const sf::Texture& getTexture(const std::string& filename);
+    const sf::SoundBuffer& getSoundBuffer(const std::string& filename);
+
+    // Return true if the file was requested and loaded without error
+    bool isLoaded(const std::string& filename) const;
+
+    // Load the assets needed at startup (Font and window icon)
+    void preload();
+
+    // Print the load time of every asset
+    void reportLoadTimes(std::ostream& output) const;
+
+private:
+    ResourceManager() {}
+    ResourceManager(const ResourceManager&) = delete;
+    ResourceManager& operator=(const ResourceManager&) = delete;
+
+    template <typename Resource>
+    const Resource& load(std::map<std::string, std::unique_ptr<Resource>>& cache, const std::string& directory, const std::string& filename);
+
+    std::map<std::string, std::unique_ptr<sf::Font>> fonts;
+    std::map<std::string, std::unique_ptr<sf::Image>> images;
+    std::map<std::string, std::unique_ptr<sf::Texture>> textures;
+    std::map<std::string, std::unique_ptr<sf::SoundBuffer>> soundBuffers;
+
+    struct LoadRecord {
+        std::string filename;
+        float milliseconds;
+        bool success;
+    };
+    std::vector<LoadRecord> loadRecords;
+};